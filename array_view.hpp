@@ -6,7 +6,7 @@
 // Created on: 12/06/16
 //
 // About:
-//  Implementation of array_view<T> and strided_array_view<T>,
+//  Implementation of array_view<T>, strided_array_view<T> and array_view_2d<T>,
 //  inspired by span<T> from GSL (AKA the C++ Core Guidelines).
 //
 // License:
@@ -27,9 +27,11 @@
 #ifndef ARRAY_VIEW_NO_STD_INCLUDES
     #include <cstddef>
     #include <cstdint>
+    #include <cstring>
     #include <utility>
     #include <iterator>
     #include <algorithm>
+    #include <functional>
     #include <type_traits>
 #endif // ARRAY_VIEW_NO_STD_INCLUDES
 
@@ -57,6 +59,92 @@
 //
 //#define ARRAY_VIEW_USE_CXX_EXCEPTIONS 1
 
+//
+// Define this switch to nonzero to make array_view::iterator and
+// const_iterator the checked array_iterator_base type, which validates
+// every dereference against the parent array_view. If defined to zero,
+// the iterators are plain pointers, which is what the optimizer likes
+// best. Defaults to the value of ARRAY_VIEW_DEBUG_CHECKS.
+//
+#ifndef ARRAY_VIEW_CHECKED_ITERATORS
+    #if ARRAY_VIEW_DEBUG_CHECKS
+        #define ARRAY_VIEW_CHECKED_ITERATORS 1
+    #endif // ARRAY_VIEW_DEBUG_CHECKS
+#endif // ARRAY_VIEW_CHECKED_ITERATORS
+
+//
+// Define this switch to disable the hand-written SIMD paths
+// (bulk strided_array_view copies, etc) and always use the
+// portable scalar code. The SIMD paths are otherwise selected
+// from the instruction sets the compiler was told to target,
+// e.g. -mavx2 / -mavx512f or /arch:AVX2 / /arch:AVX512.
+//
+//#define ARRAY_VIEW_NO_SIMD 1
+
+//
+// Define this switch to nonzero to count accesses, slices, out-of-bounds
+// indexes, iterator steps and view sizes per thread, for profiling and
+// canary builds. See get_array_view_stats(). Off by default, in which case
+// it costs nothing.
+//
+//#define ARRAY_VIEW_INSTRUMENTATION 1
+
+//
+// Define this switch to nonzero to have array_view_write_guard report
+// threads writing to overlapping ranges of memory at the same time.
+// Off by default, in which case the guards compile to nothing.
+//
+//#define ARRAY_VIEW_RACE_CHECKS 1
+
+//
+// Cache line size assumed by alignment-sensitive helpers,
+// like the default boundary alignment of partition_for_threads().
+//
+#ifndef ARRAY_VIEW_CACHE_LINE_SIZE
+    #define ARRAY_VIEW_CACHE_LINE_SIZE 64
+#endif // ARRAY_VIEW_CACHE_LINE_SIZE
+
+//
+// Minimum size in bytes for array_view::fill/copy_from/copy_to to
+// use non-temporal stores when asked to. Below it the data likely
+// still fits in the caches and normal stores are faster.
+//
+#ifndef ARRAY_VIEW_NON_TEMPORAL_THRESHOLD
+    #define ARRAY_VIEW_NON_TEMPORAL_THRESHOLD (512 * 1024)
+#endif // ARRAY_VIEW_NON_TEMPORAL_THRESHOLD
+
+//
+// How far ahead for_each_prefetched() prefetches, in bytes,
+// when not given a distance. Roughly memory latency times the
+// per-item throughput of a typical scan loop.
+//
+#ifndef ARRAY_VIEW_PREFETCH_DISTANCE_BYTES
+    #define ARRAY_VIEW_PREFETCH_DISTANCE_BYTES (16 * ARRAY_VIEW_CACHE_LINE_SIZE)
+#endif // ARRAY_VIEW_PREFETCH_DISTANCE_BYTES
+
+#ifndef ARRAY_VIEW_NO_SIMD
+    #if defined(__AVX512F__)
+        #define ARRAY_VIEW_AVX512 1
+    #endif // __AVX512F__
+    #if defined(__AVX2__)
+        #define ARRAY_VIEW_AVX2 1
+    #endif // __AVX2__
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define ARRAY_VIEW_SSE2 1
+    #endif // __SSE2__ || _M_X64 || _M_IX86_FP >= 2
+#endif // ARRAY_VIEW_NO_SIMD
+
+#ifndef ARRAY_VIEW_NO_STD_INCLUDES
+    #if ARRAY_VIEW_AVX512 || ARRAY_VIEW_AVX2
+        #include <immintrin.h>
+    #elif ARRAY_VIEW_SSE2
+        #include <emmintrin.h>
+    #endif // ARRAY_VIEW_AVX512 || ARRAY_VIEW_AVX2 || ARRAY_VIEW_SSE2
+    #if defined(_MSC_VER)
+        #include <intrin.h> // _BitScanForward
+    #endif // _MSC_VER
+#endif // ARRAY_VIEW_NO_STD_INCLUDES
+
 // ========================================================
 // array_view helpers:
 // ========================================================
@@ -85,6 +173,57 @@
     #endif // ARRAY_VIEW_USE_CXX_EXCEPTIONS or ARRAY_VIEW_USE_ASSERTS or std::cerr
 #endif // ARRAY_VIEW_ERROR
 
+// constexpr for functions that need C++14 relaxed constexpr rules
+// (more than a single return statement, non-const member functions).
+#ifndef ARRAY_VIEW_CONSTEXPR
+    #if (defined(__cplusplus) && __cplusplus >= 201402L) || (defined(_MSVC_LANG) && _MSVC_LANG >= 201402L)
+        #define ARRAY_VIEW_CONSTEXPR constexpr
+    #else // C++11
+        #define ARRAY_VIEW_CONSTEXPR
+    #endif // C++14 or newer
+#endif // ARRAY_VIEW_CONSTEXPR
+
+// True when evaluated in a constant expression. Lets constexpr functions
+// fall back from memcmp and friends, which can't run at compile-time.
+// Without compiler support this is always false, so those functions
+// still work at runtime but not in constant expressions.
+#ifndef ARRAY_VIEW_IS_CONSTANT_EVALUATED
+    #if defined(__has_builtin)
+        #if __has_builtin(__builtin_is_constant_evaluated)
+            #define ARRAY_VIEW_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+        #endif // __has_builtin(__builtin_is_constant_evaluated)
+    #endif // __has_builtin
+    #if !defined(ARRAY_VIEW_IS_CONSTANT_EVALUATED) && defined(_MSC_VER) && _MSC_VER >= 1925
+        #define ARRAY_VIEW_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+    #endif // _MSC_VER >= 1925
+    #ifndef ARRAY_VIEW_IS_CONSTANT_EVALUATED
+        #define ARRAY_VIEW_IS_CONSTANT_EVALUATED() false
+    #endif // ARRAY_VIEW_IS_CONSTANT_EVALUATED
+#endif // ARRAY_VIEW_IS_CONSTANT_EVALUATED
+
+// Software prefetch of the cache line holding address, for reading.
+// You can redefine it, e.g. to a no-op to measure its effect.
+#ifndef ARRAY_VIEW_PREFETCH
+    #if defined(__GNUC__) || defined(__clang__)
+        #define ARRAY_VIEW_PREFETCH(address) __builtin_prefetch((address), 0, 3)
+    #elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        #ifndef ARRAY_VIEW_NO_STD_INCLUDES
+            #include <xmmintrin.h>
+        #endif // ARRAY_VIEW_NO_STD_INCLUDES
+        #define ARRAY_VIEW_PREFETCH(address) _mm_prefetch(reinterpret_cast<const char *>(address), _MM_HINT_T0)
+    #else // Unknown compiler/architecture
+        #define ARRAY_VIEW_PREFETCH(address) ((void)(address))
+    #endif // __GNUC__ || __clang__ || _MSC_VER
+#endif // ARRAY_VIEW_PREFETCH
+
+// noexcept for functions that can only fail via ARRAY_VIEW_DEBUG_CHECKS,
+// since ARRAY_VIEW_ERROR may be set up to throw.
+#if ARRAY_VIEW_DEBUG_CHECKS
+    #define ARRAY_VIEW_UNCHECKED_NOEXCEPT
+#else // !ARRAY_VIEW_DEBUG_CHECKS
+    #define ARRAY_VIEW_UNCHECKED_NOEXCEPT noexcept
+#endif // ARRAY_VIEW_DEBUG_CHECKS
+
 // Size in items of statically declared C-style arrays.
 template<typename ArrayType, std::size_t ArraySize>
 constexpr std::size_t array_size(const ArrayType (&)[ArraySize]) noexcept
@@ -92,6 +231,302 @@ constexpr std::size_t array_size(const ArrayType (&)[ArraySize]) noexcept
     return ArraySize;
 }
 
+// Extent value of an array_view whose size is only known at runtime.
+constexpr std::size_t dynamic_extent = static_cast<std::size_t>(-1);
+
+// ========================================================
+// Instrumentation counters:
+// ========================================================
+
+//
+// With ARRAY_VIEW_INSTRUMENTATION defined to nonzero, array_view and
+// strided_array_view count element accesses, slices, out-of-bounds
+// attempts, iterator steps and the sizes of the views created. This is
+// meant for canary/profiling builds. Out-of-bounds indexes are counted
+// even if ARRAY_VIEW_DEBUG_CHECKS is off, and otherwise behave as usual.
+//
+// Counters are per thread, so recording one is a relaxed load and store
+// to thread-local memory, with no locking or atomic RMW. Reading them
+// with get_array_view_stats() sums all live threads plus the threads that
+// already exited. When the switch is off, the hooks expand to nothing.
+//
+// Only the checked iterators (ARRAY_VIEW_CHECKED_ITERATORS) and
+// strided_array_iterator count steps; release array_view iterators
+// are plain pointers.
+//
+#if ARRAY_VIEW_INSTRUMENTATION
+
+#ifndef ARRAY_VIEW_NO_STD_INCLUDES
+    #include <atomic>
+    #include <mutex>
+#endif // ARRAY_VIEW_NO_STD_INCLUDES
+
+//
+// Aggregated counters, as returned by get_array_view_stats().
+//
+struct array_view_stats
+{
+    enum view_kind
+    {
+        contiguous_view, // array_view
+        strided_view,    // strided_array_view
+        view_kind_count
+    };
+
+    // sizes_histogram[i] counts views created with a size in [2^(i-1), 2^i),
+    // and sizes_histogram[0] the empty views.
+    enum : std::size_t { histogram_buckets = 65 };
+
+    struct counters
+    {
+        std::uint64_t accesses;
+        std::uint64_t slices;
+        std::uint64_t out_of_bounds;
+        std::uint64_t iterator_steps;
+        std::uint64_t views_created;
+        std::uint64_t sizes_histogram[histogram_buckets];
+    };
+
+    counters kinds[view_kind_count];
+
+    // Text dump to any stream with operator<<, e.g. std::ostream.
+    // One "kind counter value" line per non-zero counter/bucket, the
+    // histogram lines are "kind size<=N count".
+    template<typename StreamType>
+    void write(StreamType & out) const
+    {
+        static const char * const kind_names[view_kind_count] = { "array_view", "strided_array_view" };
+        for (std::size_t k = 0; k < view_kind_count; ++k)
+        {
+            const counters & c = kinds[k];
+            out << kind_names[k] << " accesses "       << c.accesses       << "\n";
+            out << kind_names[k] << " slices "         << c.slices         << "\n";
+            out << kind_names[k] << " out_of_bounds "  << c.out_of_bounds  << "\n";
+            out << kind_names[k] << " iterator_steps " << c.iterator_steps << "\n";
+            out << kind_names[k] << " views_created "  << c.views_created  << "\n";
+            for (std::size_t b = 0; b < histogram_buckets; ++b)
+            {
+                if (c.sizes_histogram[b] != 0)
+                {
+                    const std::uint64_t bucket_max = (b == 0) ? 0 : (b == 64) ? ~std::uint64_t(0) : (std::uint64_t(1) << b) - 1;
+                    out << kind_names[k] << " size<=" << bucket_max << " " << c.sizes_histogram[b] << "\n";
+                }
+            }
+        }
+    }
+};
+
+namespace array_view_detail
+{
+    enum counter_id
+    {
+        counter_accesses,
+        counter_slices,
+        counter_out_of_bounds,
+        counter_iterator_steps,
+        counter_views_created,
+        counter_first_bucket,
+        counter_count = counter_first_bucket + array_view_stats::histogram_buckets
+    };
+
+    struct thread_counters
+    {
+        std::atomic<std::uint64_t> values[array_view_stats::view_kind_count][counter_count];
+        thread_counters * next;
+        thread_counters * prev;
+    };
+
+    // All live thread_counters, plus the totals of exited threads.
+    struct counters_registry
+    {
+        std::mutex        lock;
+        thread_counters * head = nullptr;
+        std::uint64_t     retired[array_view_stats::view_kind_count][counter_count] = {};
+
+        static counters_registry & instance()
+        {
+            static counters_registry registry;
+            return registry;
+        }
+    };
+
+    class thread_counters_owner final
+    {
+    public:
+        thread_counters_owner()
+        {
+            for (auto & kind : m_counters.values)
+            {
+                for (auto & value : kind)
+                {
+                    value.store(0, std::memory_order_relaxed);
+                }
+            }
+            counters_registry & registry = counters_registry::instance();
+            std::lock_guard<std::mutex> guard{ registry.lock };
+            m_counters.prev = nullptr;
+            m_counters.next = registry.head;
+            if (registry.head != nullptr)
+            {
+                registry.head->prev = &m_counters;
+            }
+            registry.head = &m_counters;
+        }
+
+        ~thread_counters_owner()
+        {
+            counters_registry & registry = counters_registry::instance();
+            std::lock_guard<std::mutex> guard{ registry.lock };
+            for (std::size_t k = 0; k < array_view_stats::view_kind_count; ++k)
+            {
+                for (std::size_t c = 0; c < counter_count; ++c)
+                {
+                    registry.retired[k][c] += m_counters.values[k][c].load(std::memory_order_relaxed);
+                }
+            }
+            (m_counters.prev != nullptr ? m_counters.prev->next : registry.head) = m_counters.next;
+            if (m_counters.next != nullptr)
+            {
+                m_counters.next->prev = m_counters.prev;
+            }
+        }
+
+        thread_counters_owner(const thread_counters_owner &) = delete;
+        thread_counters_owner & operator = (const thread_counters_owner &) = delete;
+
+        std::atomic<std::uint64_t> * counters_for(const array_view_stats::view_kind kind) noexcept
+        {
+            return m_counters.values[kind];
+        }
+
+    private:
+        thread_counters m_counters;
+    };
+
+    inline std::atomic<std::uint64_t> * local_counters(const array_view_stats::view_kind kind) noexcept
+    {
+        static thread_local thread_counters_owner owner;
+        return owner.counters_for(kind);
+    }
+
+    // Only the owning thread writes, so no atomic RMW is needed.
+    inline void bump_counter(std::atomic<std::uint64_t> & counter, const std::uint64_t amount = 1) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    inline void instrument_count(const array_view_stats::view_kind kind, const counter_id id, const std::uint64_t amount = 1) noexcept
+    {
+        bump_counter(local_counters(kind)[id], amount);
+    }
+
+    // Items moved by an iterator jump of either sign.
+    inline std::uint64_t step_count(const std::ptrdiff_t displacement) noexcept
+    {
+        return (displacement < 0) ? 0 - static_cast<std::uint64_t>(displacement) : static_cast<std::uint64_t>(displacement);
+    }
+
+    inline void instrument_access(const array_view_stats::view_kind kind, const std::size_t index, const std::size_t size) noexcept
+    {
+        std::atomic<std::uint64_t> * counters = local_counters(kind);
+        bump_counter(counters[counter_accesses]);
+        if (index >= size)
+        {
+            bump_counter(counters[counter_out_of_bounds]);
+        }
+    }
+
+    inline void instrument_view_created(const array_view_stats::view_kind kind, std::size_t size) noexcept
+    {
+        std::size_t bucket = 0;
+        for (; size != 0; size >>= 1)
+        {
+            ++bucket;
+        }
+        std::atomic<std::uint64_t> * counters = local_counters(kind);
+        bump_counter(counters[counter_views_created]);
+        bump_counter(counters[counter_first_bucket + bucket]);
+    }
+} // namespace array_view_detail {}
+
+// Sum of the counters of all threads, including the ones that exited.
+// Counts from other threads that are still running can be slightly stale.
+inline array_view_stats get_array_view_stats()
+{
+    using namespace array_view_detail;
+    std::uint64_t totals[array_view_stats::view_kind_count][counter_count];
+
+    counters_registry & registry = counters_registry::instance();
+    {
+        std::lock_guard<std::mutex> guard{ registry.lock };
+        std::memcpy(totals, registry.retired, sizeof(totals));
+        for (const thread_counters * tc = registry.head; tc != nullptr; tc = tc->next)
+        {
+            for (std::size_t k = 0; k < array_view_stats::view_kind_count; ++k)
+            {
+                for (std::size_t c = 0; c < counter_count; ++c)
+                {
+                    totals[k][c] += tc->values[k][c].load(std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    array_view_stats stats;
+    for (std::size_t k = 0; k < array_view_stats::view_kind_count; ++k)
+    {
+        array_view_stats::counters & c = stats.kinds[k];
+        c.accesses       = totals[k][counter_accesses];
+        c.slices         = totals[k][counter_slices];
+        c.out_of_bounds  = totals[k][counter_out_of_bounds];
+        c.iterator_steps = totals[k][counter_iterator_steps];
+        c.views_created  = totals[k][counter_views_created];
+        for (std::size_t b = 0; b < array_view_stats::histogram_buckets; ++b)
+        {
+            c.sizes_histogram[b] = totals[k][counter_first_bucket + b];
+        }
+    }
+    return stats;
+}
+
+// Zeroes all counters. Increments racing with this on other threads may be lost.
+inline void reset_array_view_stats()
+{
+    using namespace array_view_detail;
+    counters_registry & registry = counters_registry::instance();
+    std::lock_guard<std::mutex> guard{ registry.lock };
+    std::memset(registry.retired, 0, sizeof(registry.retired));
+    for (thread_counters * tc = registry.head; tc != nullptr; tc = tc->next)
+    {
+        for (auto & kind : tc->values)
+        {
+            for (auto & value : kind)
+            {
+                value.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+// Hooks used inside the views. Skipped in constant expressions.
+#define ARRAY_VIEW_INSTRUMENT_ACCESS(kind, index, size) \
+    do { if (!ARRAY_VIEW_IS_CONSTANT_EVALUATED()) { array_view_detail::instrument_access(array_view_stats::kind, (index), (size)); } } while (0)
+#define ARRAY_VIEW_INSTRUMENT_SLICE(kind) \
+    do { if (!ARRAY_VIEW_IS_CONSTANT_EVALUATED()) { array_view_detail::instrument_count(array_view_stats::kind, array_view_detail::counter_slices); } } while (0)
+#define ARRAY_VIEW_INSTRUMENT_STEPS(kind, count) \
+    do { if (!ARRAY_VIEW_IS_CONSTANT_EVALUATED()) { array_view_detail::instrument_count(array_view_stats::kind, array_view_detail::counter_iterator_steps, static_cast<std::uint64_t>(count)); } } while (0)
+#define ARRAY_VIEW_INSTRUMENT_CREATED(kind, size) \
+    do { if (!ARRAY_VIEW_IS_CONSTANT_EVALUATED()) { array_view_detail::instrument_view_created(array_view_stats::kind, (size)); } } while (0)
+
+#else // !ARRAY_VIEW_INSTRUMENTATION
+
+#define ARRAY_VIEW_INSTRUMENT_ACCESS(kind, index, size)
+#define ARRAY_VIEW_INSTRUMENT_SLICE(kind)
+#define ARRAY_VIEW_INSTRUMENT_STEPS(kind, count)
+#define ARRAY_VIEW_INSTRUMENT_CREATED(kind, size)
+
+#endif // ARRAY_VIEW_INSTRUMENTATION
+
 // ========================================================
 // template class array_iterator_base and friends:
 // ========================================================
@@ -100,6 +535,153 @@ namespace array_view_detail
 {
     struct mutable_iterator_tag { };
     struct const_iterator_tag   { };
+
+    // Holds the item count of an array_view. The static extent version
+    // is empty, so a fixed-size array_view is the size of a pointer.
+    template<std::size_t Extent>
+    class extent_storage
+    {
+    public:
+        constexpr extent_storage() noexcept { }
+        constexpr explicit extent_storage(std::size_t) noexcept { }
+        constexpr std::size_t stored_size() const noexcept { return Extent; }
+    };
+
+    template<>
+    class extent_storage<dynamic_extent>
+    {
+    public:
+        constexpr extent_storage() noexcept : m_size_in_items{ 0 } { }
+        constexpr explicit extent_storage(const std::size_t size_in_items) noexcept : m_size_in_items{ size_in_items } { }
+        constexpr std::size_t stored_size() const noexcept { return m_size_in_items; }
+    private:
+        std::size_t m_size_in_items;
+    };
+
+    // Holds the member offset and structure stride of a strided view/iterator.
+    // The compile-time layout is empty, the runtime one stores both values.
+    template<std::size_t OffsetBytes, std::size_t StrideBytes>
+    class stride_storage
+    {
+    public:
+        constexpr stride_storage() noexcept { }
+        constexpr stride_storage(std::size_t, std::size_t) noexcept { }
+        static constexpr std::size_t offset_bytes() noexcept { return OffsetBytes; }
+        static constexpr std::size_t stride_bytes() noexcept { return StrideBytes; }
+    };
+
+    template<>
+    class stride_storage<dynamic_extent, dynamic_extent>
+    {
+    public:
+        constexpr stride_storage() noexcept : m_offset_bytes{ 0 }, m_stride_bytes{ 0 } { }
+        constexpr stride_storage(const std::size_t offset_bytes, const std::size_t stride_bytes) noexcept
+            : m_offset_bytes{ offset_bytes }, m_stride_bytes{ stride_bytes } { }
+        constexpr std::size_t offset_bytes() const noexcept { return m_offset_bytes; }
+        constexpr std::size_t stride_bytes() const noexcept { return m_stride_bytes; }
+    private:
+        std::size_t m_offset_bytes;
+        std::size_t m_stride_bytes;
+    };
+
+    constexpr unsigned static_log2(const std::size_t n) noexcept
+    {
+        return (n <= 1) ? 0 : 1 + static_log2(n / 2);
+    }
+
+    //
+    // Byte distance between two items of a layout, in items. The distance
+    // is always an exact multiple of the stride, so for a compile-time
+    // power-of-two stride an arithmetic shift gives the same result as
+    // the division, without the rounding fix-up the compiler has to emit
+    // for a signed operator/. (Right shift of a negative value is
+    // arithmetic on every supported compiler, and required since C++20.)
+    //
+    template<std::size_t StrideBytes>
+    constexpr std::ptrdiff_t stride_distance(const std::ptrdiff_t bytes, const std::ptrdiff_t stride) noexcept
+    {
+        return (StrideBytes != dynamic_extent && StrideBytes != 0 && (StrideBytes & (StrideBytes - 1)) == 0)
+             ? (bytes >> static_log2(StrideBytes))
+             : (bytes / stride);
+    }
+
+    //
+    // True for types where two objects are equal if and only if their
+    // bytes are equal, so comparisons can use memcmp. Covers integers,
+    // enums and pointers, plus any type without padding bits when
+    // std::has_unique_object_representations is available (C++17),
+    // which assumes operator== compares all of the members.
+    // Floating-point types are excluded (NaN, -0.0). Specialize this
+    // for your own types if the default guess is wrong either way.
+    //
+    template<typename T>
+    struct is_bitwise_comparable
+        : std::integral_constant<bool, std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value
+                                       #if defined(__cpp_lib_has_unique_object_representations)
+                                       || std::has_unique_object_representations<T>::value
+                                       #endif // __cpp_lib_has_unique_object_representations
+                                       >
+    { };
+
+    template<typename T>
+    ARRAY_VIEW_CONSTEXPR bool equal_items(const T * lhs, const T * rhs, const std::size_t count, std::false_type)
+    {
+        // Plain loop instead of std::equal, which is only constexpr since C++20.
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (!(lhs[i] == rhs[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<typename T>
+    ARRAY_VIEW_CONSTEXPR bool equal_items(const T * lhs, const T * rhs, const std::size_t count, std::true_type) noexcept
+    {
+        // memcmp can't run at compile-time, use the element loop there.
+        if (ARRAY_VIEW_IS_CONSTANT_EVALUATED())
+        {
+            return equal_items(lhs, rhs, count, std::false_type{});
+        }
+        return std::memcmp(lhs, rhs, count * sizeof(T)) == 0;
+    }
+
+    // Enables the comparisons between views or iterators for any
+    // mix of mutable and const over the same item type.
+    template<typename T, typename U>
+    struct same_item_type
+        : std::is_same<typename std::remove_const<T>::type, typename std::remove_const<U>::type>
+    { };
+
+    // Extent of the array_view returned by array_view::slice<Offset, Count>().
+    template<std::size_t Extent, std::size_t Offset, std::size_t Count>
+    struct slice_extent
+        : std::integral_constant<std::size_t, (Count != dynamic_extent) ? Count :
+                                 (Extent != dynamic_extent) ? Extent - Offset : dynamic_extent>
+    { };
+
+    // Minimal std::index_sequence replacement, since that is C++14.
+    template<std::size_t... Is>
+    struct index_sequence { };
+
+    template<std::size_t N, std::size_t... Is>
+    struct make_index_sequence_impl
+        : make_index_sequence_impl<N - 1, N - 1, Is...>
+    { };
+
+    template<std::size_t... Is>
+    struct make_index_sequence_impl<0, Is...>
+    {
+        using type = index_sequence<Is...>;
+    };
+
+    template<std::size_t N>
+    using make_index_sequence = typename make_index_sequence_impl<N>::type;
+
+    // Used to expand a pack expression for its side effects in C++11.
+    using swallow = int[];
 } // namespace array_view_detail {}
 
 template
@@ -131,12 +713,12 @@ public:
     // Constructors / assignment:
     //
 
-    array_iterator_base() noexcept
+    ARRAY_VIEW_CONSTEXPR array_iterator_base() noexcept
         : m_parent_array{ nullptr }
         , m_current_index{ 0 }
     { }
 
-    array_iterator_base(parent_type * parent, const difference_type index) noexcept
+    ARRAY_VIEW_CONSTEXPR array_iterator_base(parent_type * parent, const difference_type index) noexcept
         : m_parent_array{ parent }
         , m_current_index{ index }
     { }
@@ -145,7 +727,7 @@ public:
     // Pointer-emulation operator overloads:
     //
 
-    difference_type operator - (const array_iterator_base & other) const
+    ARRAY_VIEW_CONSTEXPR difference_type operator - (const array_iterator_base & other) const
     {
         #if ARRAY_VIEW_DEBUG_CHECKS
         check_same_parent(other);
@@ -154,49 +736,49 @@ public:
         return m_current_index - other.m_current_index;
     }
 
-    array_iterator_base operator + (const difference_type displacement) const
+    ARRAY_VIEW_CONSTEXPR array_iterator_base operator + (const difference_type displacement) const
     {
         array_iterator_base temp{ *this };
         return temp.increment(displacement);
     }
-    array_iterator_base operator - (const difference_type displacement) const
+    ARRAY_VIEW_CONSTEXPR array_iterator_base operator - (const difference_type displacement) const
     {
         array_iterator_base temp{ *this };
         return temp.decrement(displacement);
     }
 
-    array_iterator_base & operator += (const difference_type displacement)
+    ARRAY_VIEW_CONSTEXPR array_iterator_base & operator += (const difference_type displacement)
     {
         return increment(displacement);
     }
-    array_iterator_base & operator -= (const difference_type displacement)
+    ARRAY_VIEW_CONSTEXPR array_iterator_base & operator -= (const difference_type displacement)
     {
         return decrement(displacement);
     }
 
-    array_iterator_base & operator++() // pre-increment
+    ARRAY_VIEW_CONSTEXPR array_iterator_base & operator++() // pre-increment
     {
         return increment(1);
     }
-    array_iterator_base operator++(int) // post-increment
+    ARRAY_VIEW_CONSTEXPR array_iterator_base operator++(int) // post-increment
     {
         array_iterator_base temp{ *this };
         increment(1);
         return temp;
     }
 
-    array_iterator_base & operator--() // pre-decrement
+    ARRAY_VIEW_CONSTEXPR array_iterator_base & operator--() // pre-decrement
     {
         return decrement(1);
     }
-    array_iterator_base operator--(int) // post-decrement
+    ARRAY_VIEW_CONSTEXPR array_iterator_base operator--(int) // post-decrement
     {
         array_iterator_base temp{ *this };
         decrement(1);
         return temp;
     }
 
-    reference operator*() const
+    ARRAY_VIEW_CONSTEXPR reference operator*() const
     {
         #if ARRAY_VIEW_DEBUG_CHECKS
         if (!is_dereferenceable())
@@ -207,7 +789,7 @@ public:
 
         return (*m_parent_array)[m_current_index];
     }
-    reference operator->() const
+    ARRAY_VIEW_CONSTEXPR reference operator->() const
     {
         #if ARRAY_VIEW_DEBUG_CHECKS
         if (!is_dereferenceable())
@@ -218,7 +800,7 @@ public:
 
         return (*m_parent_array)[m_current_index];
     }
-    reference operator[](const size_type index) const
+    ARRAY_VIEW_CONSTEXPR reference operator[](const size_type index) const
     {
         #if ARRAY_VIEW_DEBUG_CHECKS
         if (!is_dereferenceable())
@@ -239,16 +821,16 @@ public:
         return (*m_parent_array)[array_index];
     }
 
-    bool operator == (std::nullptr_t) const noexcept
+    ARRAY_VIEW_CONSTEXPR bool operator == (std::nullptr_t) const noexcept
     {
         return m_parent_array == nullptr;
     }
-    bool operator != (std::nullptr_t) const noexcept
+    ARRAY_VIEW_CONSTEXPR bool operator != (std::nullptr_t) const noexcept
     {
         return !(*this == nullptr);
     }
 
-    bool operator == (const array_iterator_base & other) const
+    ARRAY_VIEW_CONSTEXPR bool operator == (const array_iterator_base & other) const
     {
         #if ARRAY_VIEW_DEBUG_CHECKS
         check_same_parent(other);
@@ -256,12 +838,12 @@ public:
 
         return m_current_index == other.m_current_index;
     }
-    bool operator != (const array_iterator_base & other) const
+    ARRAY_VIEW_CONSTEXPR bool operator != (const array_iterator_base & other) const
     {
         return !(*this == other);
     }
 
-    bool operator < (const array_iterator_base & other) const
+    ARRAY_VIEW_CONSTEXPR bool operator < (const array_iterator_base & other) const
     {
         #if ARRAY_VIEW_DEBUG_CHECKS
         check_same_parent(other);
@@ -269,7 +851,7 @@ public:
 
         return m_current_index < other.m_current_index;
     }
-    bool operator > (const array_iterator_base & other) const
+    ARRAY_VIEW_CONSTEXPR bool operator > (const array_iterator_base & other) const
     {
         #if ARRAY_VIEW_DEBUG_CHECKS
         check_same_parent(other);
@@ -278,11 +860,11 @@ public:
         return m_current_index > other.m_current_index;
     }
 
-    bool operator <= (const array_iterator_base & other) const
+    ARRAY_VIEW_CONSTEXPR bool operator <= (const array_iterator_base & other) const
     {
         return !(*this > other);
     }
-    bool operator >= (const array_iterator_base & other) const
+    ARRAY_VIEW_CONSTEXPR bool operator >= (const array_iterator_base & other) const
     {
         return !(*this < other);
     }
@@ -291,7 +873,7 @@ public:
     // One way conversion from mutable_iterator to const_iterator:
     //
 
-    operator array_iterator_base<const value_type, const parent_type, array_view_detail::const_iterator_tag>() const noexcept
+    constexpr operator array_iterator_base<const value_type, const parent_type, array_view_detail::const_iterator_tag>() const noexcept
     {
         return array_iterator_base<const value_type, const parent_type, array_view_detail::const_iterator_tag>{ m_parent_array, m_current_index };
     }
@@ -309,14 +891,14 @@ public:
 
 private:
 
-    bool is_dereferenceable() const noexcept
+    ARRAY_VIEW_CONSTEXPR bool is_dereferenceable() const noexcept
     {
         return m_parent_array != nullptr && m_current_index >= 0 &&
                static_cast<size_type>(m_current_index) < m_parent_array->size();
     }
 
     #if ARRAY_VIEW_DEBUG_CHECKS
-    void check_same_parent(const array_iterator_base & other) const
+    ARRAY_VIEW_CONSTEXPR void check_same_parent(const array_iterator_base & other) const
     {
         if (m_parent_array != other.m_parent_array)
         {
@@ -325,7 +907,7 @@ private:
     }
     #endif // ARRAY_VIEW_DEBUG_CHECKS
 
-    array_iterator_base & increment(const difference_type displacement)
+    ARRAY_VIEW_CONSTEXPR array_iterator_base & increment(const difference_type displacement)
     {
         #if ARRAY_VIEW_DEBUG_CHECKS
         if (m_parent_array == nullptr)
@@ -334,11 +916,12 @@ private:
         }
         #endif // ARRAY_VIEW_DEBUG_CHECKS
 
+        ARRAY_VIEW_INSTRUMENT_STEPS(contiguous_view, array_view_detail::step_count(displacement));
         m_current_index += displacement;
         return *this;
     }
 
-    array_iterator_base & decrement(const difference_type displacement)
+    ARRAY_VIEW_CONSTEXPR array_iterator_base & decrement(const difference_type displacement)
     {
         #if ARRAY_VIEW_DEBUG_CHECKS
         if (m_parent_array == nullptr)
@@ -347,6 +930,7 @@ private:
         }
         #endif // ARRAY_VIEW_DEBUG_CHECKS
 
+        ARRAY_VIEW_INSTRUMENT_STEPS(contiguous_view, array_view_detail::step_count(displacement));
         m_current_index -= displacement;
         return *this;
     }
@@ -361,208 +945,2892 @@ private:
 };
 
 // ========================================================
-// template class array_view:
+// array_view bulk store helpers:
 // ========================================================
 
-template<typename T>
-class array_view final
+//
+// Store hint for array_view::fill(), copy_from() and copy_to().
+// non_temporal writes around the caches (SSE2 streaming stores)
+// for buffers that won't be read back soon, so they don't evict
+// everything else. It falls back to normal stores below
+// ARRAY_VIEW_NON_TEMPORAL_THRESHOLD bytes, for types it can't
+// handle and on targets without SSE2.
+//
+enum class array_view_store_hint
 {
-public:
-
-    //
-    // Nested types:
-    //
-
-    using value_type             = T;
-    using size_type              = std::size_t;
-    using difference_type        = std::ptrdiff_t;
-
-    using pointer                = typename std::add_pointer<value_type>::type;
-    using reference              = typename std::add_lvalue_reference<value_type>::type;
-    using const_pointer          = typename std::add_pointer<const value_type>::type;
-    using const_reference        = typename std::add_lvalue_reference<const value_type>::type;
-
-    using iterator               = array_iterator_base<value_type, array_view, array_view_detail::mutable_iterator_tag>;
-    using const_iterator         = array_iterator_base<const value_type, const array_view, array_view_detail::const_iterator_tag>;
-    using reverse_iterator       = std::reverse_iterator<iterator>;
-    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
-
-    //
-    // Constructors / assignment:
-    //
-
-    array_view() noexcept
-        : m_pointer{ nullptr }
-        , m_size_in_items{ 0 }
-    { }
-
-    template<typename ArrayType, std::size_t ArraySize>
-    explicit array_view(ArrayType (&arr)[ArraySize]) noexcept
-        : m_pointer{ arr }
-        , m_size_in_items{ ArraySize }
-    { }
-
-    template<typename ContainerType>
-    explicit array_view(ContainerType & container) noexcept
-        : m_pointer{ container.data() }
-        , m_size_in_items{ container.size() }
-    { }
-
-    template<typename ConvertibleType>
-    array_view(ConvertibleType * array_ptr, const size_type size_in_items) noexcept
-        : m_pointer{ array_ptr }
-        , m_size_in_items{ size_in_items }
-    { }
-
-    template<typename ConvertibleType>
-    array_view(array_view<ConvertibleType> other) noexcept
-        : m_pointer{ other.data() }
-        , m_size_in_items{ other.size() }
-    { }
+    normal,
+    non_temporal
+};
 
-    template<typename ConvertibleType>
-    array_view & operator = (array_view<ConvertibleType> other) noexcept
+namespace array_view_detail
+{
+    #if ARRAY_VIEW_SSE2
+    template<typename T>
+    inline bool use_non_temporal_stores(const array_view_store_hint hint, const std::size_t count) noexcept
     {
-        m_pointer = other.data();
-        m_size_in_items = other.size();
-        return *this;
+        return hint == array_view_store_hint::non_temporal &&
+               std::is_trivially_copyable<T>::value &&
+               count * sizeof(T) >= ARRAY_VIEW_NON_TEMPORAL_THRESHOLD;
     }
 
-    //
-    // Helper methods:
-    //
-
-    void reset() noexcept
+    // memcpy with streaming stores. The destination is aligned
+    // with a memcpy head, the source is read with unaligned loads.
+    inline void non_temporal_copy(void * dest, const void * source, std::size_t size_in_bytes) noexcept
     {
-        m_pointer = nullptr;
-        m_size_in_items = 0;
-    }
+        auto * dest_bytes         = static_cast<std::uint8_t *>(dest);
+        const auto * source_bytes = static_cast<const std::uint8_t *>(source);
 
-    array_view slice(const size_type offset_in_items) const
-    {
-        if (data() == nullptr || empty())
+        // Clamped for copies shorter than the head, possible with a small
+        // user-defined ARRAY_VIEW_NON_TEMPORAL_THRESHOLD.
+        const std::size_t head = std::min<std::size_t>((16 - (reinterpret_cast<std::uintptr_t>(dest_bytes) & 15)) & 15, size_in_bytes);
+        std::memcpy(dest_bytes, source_bytes, head);
+        dest_bytes += head; source_bytes += head; size_in_bytes -= head;
+
+        for (; size_in_bytes >= 64; size_in_bytes -= 64, dest_bytes += 64, source_bytes += 64)
         {
-            return {}; // Empty slice.
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source_bytes));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source_bytes + 16));
+            const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source_bytes + 32));
+            const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source_bytes + 48));
+            _mm_stream_si128(reinterpret_cast<__m128i *>(dest_bytes),      a);
+            _mm_stream_si128(reinterpret_cast<__m128i *>(dest_bytes + 16), b);
+            _mm_stream_si128(reinterpret_cast<__m128i *>(dest_bytes + 32), c);
+            _mm_stream_si128(reinterpret_cast<__m128i *>(dest_bytes + 48), d);
         }
-
-        #if ARRAY_VIEW_DEBUG_CHECKS
-        if (offset_in_items >= size())
+        for (; size_in_bytes >= 16; size_in_bytes -= 16, dest_bytes += 16, source_bytes += 16)
         {
-            ARRAY_VIEW_ERROR("array_view slice offset greater or equal size!");
+            _mm_stream_si128(reinterpret_cast<__m128i *>(dest_bytes),
+                             _mm_loadu_si128(reinterpret_cast<const __m128i *>(source_bytes)));
         }
-        #endif // ARRAY_VIEW_DEBUG_CHECKS
 
-        return slice(offset_in_items, size() - offset_in_items);
+        // Streaming stores are weakly ordered; make them visible
+        // before anything stored after this function returns.
+        _mm_sfence();
+        std::memcpy(dest_bytes, source_bytes, size_in_bytes);
     }
 
-    array_view slice(const size_type offset_in_items, const size_type item_count) const
+    // Fill with streaming stores of a 16 byte pattern, for sizes that
+    // divide 16 and items aligned to their size. Returns false if the
+    // type/address isn't supported, leaving the memory untouched.
+    template<typename T>
+    inline bool non_temporal_fill(T * dest, std::size_t count, const T & value) noexcept
     {
-        if (data() == nullptr || empty() || item_count == 0)
+        if (16 % sizeof(T) != 0 || (reinterpret_cast<std::uintptr_t>(dest) % sizeof(T)) != 0)
         {
-            return {}; // Empty slice.
+            return false;
         }
 
-        #if ARRAY_VIEW_DEBUG_CHECKS
-        if (item_count == 0)
+        for (; count != 0 && (reinterpret_cast<std::uintptr_t>(dest) & 15) != 0; --count)
         {
-            ARRAY_VIEW_ERROR("array_view slice with zero size!");
+            std::memcpy(static_cast<void *>(dest++), &value, sizeof(T));
         }
-        if (offset_in_items >= size())
+
+        std::uint8_t pattern_bytes[16];
+        for (std::size_t i = 0; i < 16; i += sizeof(T))
         {
-            ARRAY_VIEW_ERROR("array_view slice offset greater or equal size!");
+            std::memcpy(pattern_bytes + i, &value, sizeof(T));
         }
-        if (offset_in_items + item_count > size())
+        const __m128i pattern = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pattern_bytes));
+
+        constexpr std::size_t items_per_vector = 16 / sizeof(T);
+        auto * dest_vec = reinterpret_cast<__m128i *>(dest);
+        for (; count >= 4 * items_per_vector; count -= 4 * items_per_vector, dest_vec += 4)
         {
-            ARRAY_VIEW_ERROR("array_view slice size is greater than total size!");
+            _mm_stream_si128(dest_vec,     pattern);
+            _mm_stream_si128(dest_vec + 1, pattern);
+            _mm_stream_si128(dest_vec + 2, pattern);
+            _mm_stream_si128(dest_vec + 3, pattern);
+        }
+        for (; count >= items_per_vector; count -= items_per_vector, ++dest_vec)
+        {
+            _mm_stream_si128(dest_vec, pattern);
         }
-        #endif // ARRAY_VIEW_DEBUG_CHECKS
 
-        return { m_pointer + offset_in_items, item_count };
+        _mm_sfence();
+        for (dest = reinterpret_cast<T *>(dest_vec); count != 0; --count)
+        {
+            std::memcpy(static_cast<void *>(dest++), &value, sizeof(T));
+        }
+        return true;
     }
+    #endif // ARRAY_VIEW_SSE2
 
-    //
+    // True if all bytes of the value are zero, so fill() can memset.
+    template<typename T>
+    inline bool is_zero_bytes(const T & value) noexcept
+    {
+        const auto * bytes = reinterpret_cast<const unsigned char *>(&value);
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+        {
+            if (bytes[i] != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<typename T>
+    void fill_items(T * dest, const std::size_t count, const T & value, const array_view_store_hint hint)
+    {
+        #if ARRAY_VIEW_SSE2
+        if (use_non_temporal_stores<T>(hint, count) && non_temporal_fill(dest, count, value))
+        {
+            return;
+        }
+        #else // !ARRAY_VIEW_SSE2
+        (void)hint;
+        #endif // ARRAY_VIEW_SSE2
+
+        if (std::is_trivially_copyable<T>::value && (sizeof(T) == 1 || is_zero_bytes(value)))
+        {
+            if (count != 0)
+            {
+                std::memset(static_cast<void *>(dest), *reinterpret_cast<const unsigned char *>(&value), count * sizeof(T));
+            }
+        }
+        else
+        {
+            std::fill(dest, dest + count, value);
+        }
+    }
+
+    template<typename T>
+    void copy_items_normal(T * dest, const T * source, const std::size_t count, std::true_type) noexcept
+    {
+        if (count != 0)
+        {
+            std::memcpy(static_cast<void *>(dest), source, count * sizeof(T));
+        }
+    }
+    template<typename T>
+    void copy_items_normal(T * dest, const T * source, const std::size_t count, std::false_type)
+    {
+        std::copy(source, source + count, dest);
+    }
+
+    template<typename T>
+    void copy_items(T * dest, const T * source, const std::size_t count, const array_view_store_hint hint)
+    {
+        #if ARRAY_VIEW_SSE2
+        if (use_non_temporal_stores<T>(hint, count))
+        {
+            non_temporal_copy(dest, source, count * sizeof(T));
+            return;
+        }
+        #else // !ARRAY_VIEW_SSE2
+        (void)hint;
+        #endif // ARRAY_VIEW_SSE2
+
+        copy_items_normal(dest, source, count, std::is_trivially_copyable<T>{});
+    }
+
+} // namespace array_view_detail {}
+
+// ========================================================
+// array_view search helpers:
+// ========================================================
+
+namespace array_view_detail
+{
+    //
+    // Element types that find()/count()/find_first_of() compare as
+    // raw SIMD lanes: 1, 2 and 4 byte integers and enums. Everything
+    // else uses operator== in a plain loop.
+    //
+    template<typename T>
+    struct is_simd_searchable
+        : std::integral_constant<bool, (std::is_integral<T>::value || std::is_enum<T>::value) &&
+                                       !std::is_same<T, bool>::value &&
+                                       (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4)>
+    { };
+
+    // x must not be zero.
+    inline unsigned count_trailing_zeros(const std::uint32_t x) noexcept
+    {
+        #if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctz(x));
+        #elif defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, x);
+        return static_cast<unsigned>(index);
+        #else // Portable fallback
+        unsigned index = 0;
+        for (std::uint32_t bits = x; (bits & 1) == 0; bits >>= 1)
+        {
+            ++index;
+        }
+        return index;
+        #endif // __GNUC__ || __clang__ || _MSC_VER
+    }
+
+    inline unsigned population_count(std::uint32_t x) noexcept
+    {
+        #if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_popcount(x));
+        #else // SWAR bit count
+        x = x - ((x >> 1) & 0x55555555u);
+        x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+        x = (x + (x >> 4)) & 0x0F0F0F0Fu;
+        return static_cast<unsigned>((x * 0x01010101u) >> 24);
+        #endif // __GNUC__ || __clang__
+    }
+
+    // Bits of value zero-extended to 32, for broadcasting into SIMD lanes.
+    template<typename T>
+    inline std::uint32_t lane_bits(const T & value) noexcept
+    {
+        std::uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(T));
+        return bits;
+    }
+
+    //
+    // Equality masks over one vector of items: bit i is set if byte i
+    // belongs to an item equal to the needle, as _mm_movemask_epi8()
+    // gives them. For 2 and 4 byte items each match sets 2 or 4 bits,
+    // so the item index is the bit index divided by sizeof(T).
+    //
+    #if ARRAY_VIEW_AVX2
+    constexpr std::size_t search_vector_size = 32;
+    using search_vector = __m256i;
+
+    template<std::size_t Width> search_vector search_splat(std::uint32_t bits) noexcept;
+    template<> inline search_vector search_splat<1>(const std::uint32_t bits) noexcept { return _mm256_set1_epi8(static_cast<char>(bits)); }
+    template<> inline search_vector search_splat<2>(const std::uint32_t bits) noexcept { return _mm256_set1_epi16(static_cast<short>(bits)); }
+    template<> inline search_vector search_splat<4>(const std::uint32_t bits) noexcept { return _mm256_set1_epi32(static_cast<int>(bits)); }
+
+    template<std::size_t Width> search_vector search_equal(search_vector a, search_vector b) noexcept;
+    template<> inline search_vector search_equal<1>(const search_vector a, const search_vector b) noexcept { return _mm256_cmpeq_epi8(a, b);  }
+    template<> inline search_vector search_equal<2>(const search_vector a, const search_vector b) noexcept { return _mm256_cmpeq_epi16(a, b); }
+    template<> inline search_vector search_equal<4>(const search_vector a, const search_vector b) noexcept { return _mm256_cmpeq_epi32(a, b); }
+
+    inline search_vector search_load(const void * ptr) noexcept { return _mm256_loadu_si256(static_cast<const __m256i *>(ptr)); }
+    inline search_vector search_or(const search_vector a, const search_vector b) noexcept { return _mm256_or_si256(a, b); }
+    inline std::uint32_t search_mask(const search_vector v) noexcept { return static_cast<std::uint32_t>(_mm256_movemask_epi8(v)); }
+    #elif ARRAY_VIEW_SSE2
+    constexpr std::size_t search_vector_size = 16;
+    using search_vector = __m128i;
+
+    template<std::size_t Width> search_vector search_splat(std::uint32_t bits) noexcept;
+    template<> inline search_vector search_splat<1>(const std::uint32_t bits) noexcept { return _mm_set1_epi8(static_cast<char>(bits)); }
+    template<> inline search_vector search_splat<2>(const std::uint32_t bits) noexcept { return _mm_set1_epi16(static_cast<short>(bits)); }
+    template<> inline search_vector search_splat<4>(const std::uint32_t bits) noexcept { return _mm_set1_epi32(static_cast<int>(bits)); }
+
+    template<std::size_t Width> search_vector search_equal(search_vector a, search_vector b) noexcept;
+    template<> inline search_vector search_equal<1>(const search_vector a, const search_vector b) noexcept { return _mm_cmpeq_epi8(a, b);  }
+    template<> inline search_vector search_equal<2>(const search_vector a, const search_vector b) noexcept { return _mm_cmpeq_epi16(a, b); }
+    template<> inline search_vector search_equal<4>(const search_vector a, const search_vector b) noexcept { return _mm_cmpeq_epi32(a, b); }
+
+    inline search_vector search_load(const void * ptr) noexcept { return _mm_loadu_si128(static_cast<const __m128i *>(ptr)); }
+    inline search_vector search_or(const search_vector a, const search_vector b) noexcept { return _mm_or_si128(a, b); }
+    inline std::uint32_t search_mask(const search_vector v) noexcept { return static_cast<std::uint32_t>(_mm_movemask_epi8(v)); }
+    #endif // ARRAY_VIEW_AVX2 || ARRAY_VIEW_SSE2
+
+    //
+    // find_items(): index of the first item equal to value, or count.
+    //
+
+    template<typename T>
+    std::size_t find_items(const T * items, const std::size_t count, const T & value, std::false_type /* simd */)
+    {
+        return static_cast<std::size_t>(std::find(items, items + count, value) - items);
+    }
+
+    template<typename T>
+    std::size_t find_items(const T * items, const std::size_t count, const T & value, std::true_type /* simd */) noexcept
+    {
+        // The C library's memchr is already vectorized on every platform that matters.
+        if (sizeof(T) == 1)
+        {
+            const void * const match = (count != 0) ? std::memchr(items, static_cast<int>(lane_bits(value)), count) : nullptr;
+            return (match != nullptr) ? static_cast<std::size_t>(static_cast<const T *>(match) - items) : count;
+        }
+
+        std::size_t i = 0;
+        #if ARRAY_VIEW_AVX2 || ARRAY_VIEW_SSE2
+        constexpr std::size_t items_per_vector = search_vector_size / sizeof(T);
+        const search_vector needle = search_splat<sizeof(T)>(lane_bits(value));
+        for (; i + items_per_vector <= count; i += items_per_vector)
+        {
+            const std::uint32_t mask = search_mask(search_equal<sizeof(T)>(search_load(items + i), needle));
+            if (mask != 0)
+            {
+                return i + count_trailing_zeros(mask) / sizeof(T);
+            }
+        }
+        #endif // ARRAY_VIEW_AVX2 || ARRAY_VIEW_SSE2
+        for (; i < count; ++i)
+        {
+            if (items[i] == value)
+            {
+                return i;
+            }
+        }
+        return count;
+    }
+
+    //
+    // count_items(): number of items equal to value.
+    //
+
+    template<typename T>
+    std::size_t count_items(const T * items, const std::size_t count, const T & value, std::false_type /* simd */)
+    {
+        return static_cast<std::size_t>(std::count(items, items + count, value));
+    }
+
+    template<typename T>
+    std::size_t count_items(const T * items, const std::size_t count, const T & value, std::true_type /* simd */) noexcept
+    {
+        std::size_t i = 0;
+        std::size_t matches = 0;
+        #if ARRAY_VIEW_AVX2 || ARRAY_VIEW_SSE2
+        constexpr std::size_t items_per_vector = search_vector_size / sizeof(T);
+        const search_vector needle = search_splat<sizeof(T)>(lane_bits(value));
+        std::size_t matching_bits = 0;
+        for (; i + items_per_vector <= count; i += items_per_vector)
+        {
+            matching_bits += population_count(search_mask(search_equal<sizeof(T)>(search_load(items + i), needle)));
+        }
+        matches = matching_bits / sizeof(T);
+        #endif // ARRAY_VIEW_AVX2 || ARRAY_VIEW_SSE2
+        // Without SSE2 the compiler is left to vectorize this loop.
+        for (; i < count; ++i)
+        {
+            matches += (items[i] == value) ? 1 : 0;
+        }
+        return matches;
+    }
+
+    //
+    // find_first_of_items(): index of the first item equal to any of
+    // the set, or count. Byte sets bigger than a few values use a
+    // 256 entry table; smaller sets are compared a vector at a time.
+    //
+
+    template<typename T>
+    std::size_t find_first_of_items(const T * items, const std::size_t count,
+                                    const T * set, const std::size_t set_count, std::false_type /* simd */)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            for (std::size_t s = 0; s < set_count; ++s)
+            {
+                if (items[i] == set[s])
+                {
+                    return i;
+                }
+            }
+        }
+        return count;
+    }
+
+    constexpr std::size_t max_simd_search_set = 4;
+
+    template<typename T>
+    std::size_t find_first_of_items(const T * items, const std::size_t count,
+                                    const T * set, const std::size_t set_count, std::true_type /* simd */) noexcept
+    {
+        if (set_count == 1)
+        {
+            return find_items(items, count, set[0], std::true_type{});
+        }
+
+        if (sizeof(T) == 1 && set_count > max_simd_search_set)
+        {
+            bool in_set[256] = {};
+            for (std::size_t s = 0; s < set_count; ++s)
+            {
+                in_set[lane_bits(set[s])] = true;
+            }
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (in_set[lane_bits(items[i])])
+                {
+                    return i;
+                }
+            }
+            return count;
+        }
+
+        std::size_t i = 0;
+        #if ARRAY_VIEW_AVX2 || ARRAY_VIEW_SSE2
+        if (set_count <= max_simd_search_set)
+        {
+            constexpr std::size_t items_per_vector = search_vector_size / sizeof(T);
+            search_vector needles[max_simd_search_set];
+            for (std::size_t s = 0; s < set_count; ++s)
+            {
+                needles[s] = search_splat<sizeof(T)>(lane_bits(set[s]));
+            }
+            for (; i + items_per_vector <= count; i += items_per_vector)
+            {
+                const search_vector chunk = search_load(items + i);
+                search_vector matches = search_equal<sizeof(T)>(chunk, needles[0]);
+                for (std::size_t s = 1; s < set_count; ++s)
+                {
+                    matches = search_or(matches, search_equal<sizeof(T)>(chunk, needles[s]));
+                }
+                const std::uint32_t mask = search_mask(matches);
+                if (mask != 0)
+                {
+                    return i + count_trailing_zeros(mask) / sizeof(T);
+                }
+            }
+        }
+        #endif // ARRAY_VIEW_AVX2 || ARRAY_VIEW_SSE2
+        const std::size_t found = find_first_of_items(items + i, count - i, set, set_count, std::false_type{});
+        return i + found;
+    }
+} // namespace array_view_detail {}
+
+// ========================================================
+// template class array_view:
+// ========================================================
+
+template<typename T>
+class array_view_partitions;
+
+template<typename T>
+class array_view_split;
+
+//
+// array_view<T> holds a pointer and a runtime item count.
+// array_view<T, N> has its size fixed at compile time and
+// only stores the pointer. size() is then a constant the
+// optimizer can fold into loop trip counts and bounds checks.
+//
+template
+<
+    typename T,
+    std::size_t Extent = dynamic_extent
+>
+class array_view final
+    : private array_view_detail::extent_storage<Extent>
+{
+    using extent_storage_type = array_view_detail::extent_storage<Extent>;
+
+public:
+
+    //
+    // Nested types:
+    //
+
+    using value_type             = T;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+
+    using pointer                = typename std::add_pointer<value_type>::type;
+    using reference              = typename std::add_lvalue_reference<value_type>::type;
+    using const_pointer          = typename std::add_pointer<const value_type>::type;
+    using const_reference        = typename std::add_lvalue_reference<const value_type>::type;
+
+    #if ARRAY_VIEW_CHECKED_ITERATORS
+    using iterator               = array_iterator_base<value_type, array_view, array_view_detail::mutable_iterator_tag>;
+    using const_iterator         = array_iterator_base<const value_type, const array_view, array_view_detail::const_iterator_tag>;
+    #else // !ARRAY_VIEW_CHECKED_ITERATORS
+    // Release iterators are just pointers into the viewed memory. They
+    // don't reference the array_view, so they stay valid after a temporary
+    // view goes away, and the compiler sees the same code as for a T* loop.
+    using iterator               = pointer;
+    using const_iterator         = const_pointer;
+    #endif // ARRAY_VIEW_CHECKED_ITERATORS
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // Same view type but with the size only known at runtime.
+    using dynamic_view_type      = array_view<value_type, dynamic_extent>;
+
+    // Compile-time size or dynamic_extent.
+    static constexpr size_type extent = Extent;
+
+    //
+    // Constructors / assignment:
+    //
+
+    // A fixed-size array_view always points to something,
+    // so only dynamic or zero-sized views are default constructible.
+    template<size_type E = Extent, typename std::enable_if<E == dynamic_extent || E == 0, int>::type = 0>
+    constexpr array_view() noexcept
+        : extent_storage_type{ 0 }
+        , m_pointer{ nullptr }
+    { }
+
+    template<typename ArrayType, std::size_t ArraySize>
+    constexpr explicit array_view(ArrayType (&arr)[ArraySize]) noexcept
+        : extent_storage_type{ ArraySize }
+        , m_pointer{ arr }
+    {
+        static_assert(Extent == dynamic_extent || Extent == ArraySize,
+                      "array_view extent doesn't match the size of the array!");
+    }
+
+    template<typename ContainerType>
+    ARRAY_VIEW_CONSTEXPR explicit array_view(ContainerType & container) ARRAY_VIEW_UNCHECKED_NOEXCEPT
+        : extent_storage_type{ container.size() }
+        , m_pointer{ container.data() }
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        check_extent(container.size());
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+        ARRAY_VIEW_INSTRUMENT_CREATED(contiguous_view, container.size());
+    }
+
+    template<typename ConvertibleType>
+    ARRAY_VIEW_CONSTEXPR array_view(ConvertibleType * array_ptr, const size_type size_in_items) ARRAY_VIEW_UNCHECKED_NOEXCEPT
+        : extent_storage_type{ size_in_items }
+        , m_pointer{ array_ptr }
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        check_extent(size_in_items);
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+        ARRAY_VIEW_INSTRUMENT_CREATED(contiguous_view, size_in_items);
+    }
+
+    // Implicit conversion between views of compatible extents (any extent
+    // to dynamic, or same static extent). U[] to const U[] is also allowed.
+    template
+    <
+        typename ConvertibleType,
+        std::size_t OtherExtent,
+        typename std::enable_if<Extent == dynamic_extent || Extent == OtherExtent, int>::type = 0
+    >
+    ARRAY_VIEW_CONSTEXPR array_view(array_view<ConvertibleType, OtherExtent> other) noexcept
+        : extent_storage_type{ other.size() }
+        , m_pointer{ other.data() }
+    { }
+
+    // Going from a dynamic to a static extent must be spelled out.
+    // The runtime size is validated against Extent with ARRAY_VIEW_DEBUG_CHECKS.
+    template
+    <
+        typename ConvertibleType,
+        size_type E = Extent,
+        typename std::enable_if<E != dynamic_extent, int>::type = 0
+    >
+    ARRAY_VIEW_CONSTEXPR explicit array_view(array_view<ConvertibleType, dynamic_extent> other) ARRAY_VIEW_UNCHECKED_NOEXCEPT
+        : extent_storage_type{ other.size() }
+        , m_pointer{ other.data() }
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        check_extent(other.size());
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+        ARRAY_VIEW_INSTRUMENT_CREATED(contiguous_view, other.size());
+    }
+
+    template
+    <
+        typename ConvertibleType,
+        std::size_t OtherExtent,
+        typename std::enable_if<Extent == dynamic_extent || Extent == OtherExtent, int>::type = 0
+    >
+    ARRAY_VIEW_CONSTEXPR array_view & operator = (array_view<ConvertibleType, OtherExtent> other) noexcept
+    {
+        static_cast<extent_storage_type &>(*this) = extent_storage_type{ other.size() };
+        m_pointer = other.data();
+        return *this;
+    }
+
+    //
+    // Helper methods:
+    //
+
+    template<size_type E = Extent, typename std::enable_if<E == dynamic_extent, int>::type = 0>
+    ARRAY_VIEW_CONSTEXPR void reset() noexcept
+    {
+        static_cast<extent_storage_type &>(*this) = extent_storage_type{ 0 };
+        m_pointer = nullptr;
+    }
+
+    // Slice with offset and count known at compile-time. The result
+    // has a static extent. For a static source view the range is
+    // validated by the compiler, otherwise by ARRAY_VIEW_DEBUG_CHECKS.
+    // A Count of dynamic_extent means everything after Offset.
+    template<size_type Offset, size_type Count = dynamic_extent>
+    ARRAY_VIEW_CONSTEXPR array_view<value_type, array_view_detail::slice_extent<Extent, Offset, Count>::value> slice() const
+    {
+        ARRAY_VIEW_INSTRUMENT_SLICE(contiguous_view);
+        static_assert(Extent == dynamic_extent || Offset <= Extent,
+                      "array_view slice offset greater than size!");
+        static_assert(Extent == dynamic_extent || Count == dynamic_extent || Offset + Count <= Extent,
+                      "array_view slice size is greater than total size!");
+
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (Offset > size())
+        {
+            ARRAY_VIEW_ERROR("array_view slice offset greater than size!");
+        }
+        if (Count != dynamic_extent && Offset + Count > size())
+        {
+            ARRAY_VIEW_ERROR("array_view slice size is greater than total size!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return array_view<value_type, array_view_detail::slice_extent<Extent, Offset, Count>::value>{
+            m_pointer + Offset, (Count != dynamic_extent) ? Count : size() - Offset };
+    }
+
+    ARRAY_VIEW_CONSTEXPR dynamic_view_type slice(const size_type offset_in_items) const
+    {
+        if (data() == nullptr || empty())
+        {
+            return {}; // Empty slice.
+        }
+
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (offset_in_items >= size())
+        {
+            ARRAY_VIEW_ERROR("array_view slice offset greater or equal size!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return slice(offset_in_items, size() - offset_in_items);
+    }
+
+    ARRAY_VIEW_CONSTEXPR dynamic_view_type slice(const size_type offset_in_items, const size_type item_count) const
+    {
+        ARRAY_VIEW_INSTRUMENT_SLICE(contiguous_view);
+        if (data() == nullptr || empty() || item_count == 0)
+        {
+            return {}; // Empty slice.
+        }
+
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (item_count == 0)
+        {
+            ARRAY_VIEW_ERROR("array_view slice with zero size!");
+        }
+        if (offset_in_items >= size())
+        {
+            ARRAY_VIEW_ERROR("array_view slice offset greater or equal size!");
+        }
+        if (offset_in_items + item_count > size())
+        {
+            ARRAY_VIEW_ERROR("array_view slice size is greater than total size!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return { m_pointer + offset_in_items, item_count };
+    }
+
+    //
+    // Unchecked slicing for hot paths:
+    //
+    // Unlike slice(), these never test for null or empty views, so in
+    // release builds they are just pointer arithmetic. The counts are
+    // only validated with ARRAY_VIEW_DEBUG_CHECKS.
+    //
+
+    // The first item_count items.
+    ARRAY_VIEW_CONSTEXPR dynamic_view_type first(const size_type item_count) const ARRAY_VIEW_UNCHECKED_NOEXCEPT
+    {
+        ARRAY_VIEW_INSTRUMENT_SLICE(contiguous_view);
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (item_count > size())
+        {
+            ARRAY_VIEW_ERROR("array_view::first(): count is greater than size!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return dynamic_view_type{ m_pointer, item_count };
+    }
+
+    // The last item_count items.
+    ARRAY_VIEW_CONSTEXPR dynamic_view_type last(const size_type item_count) const ARRAY_VIEW_UNCHECKED_NOEXCEPT
+    {
+        ARRAY_VIEW_INSTRUMENT_SLICE(contiguous_view);
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (item_count > size())
+        {
+            ARRAY_VIEW_ERROR("array_view::last(): count is greater than size!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return dynamic_view_type{ m_pointer + (size() - item_count), item_count };
+    }
+
+    // Everything but the first item_count items.
+    ARRAY_VIEW_CONSTEXPR dynamic_view_type drop_front(const size_type item_count) const ARRAY_VIEW_UNCHECKED_NOEXCEPT
+    {
+        ARRAY_VIEW_INSTRUMENT_SLICE(contiguous_view);
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (item_count > size())
+        {
+            ARRAY_VIEW_ERROR("array_view::drop_front(): count is greater than size!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return dynamic_view_type{ m_pointer + item_count, size() - item_count };
+    }
+
+    // Everything but the last item_count items.
+    ARRAY_VIEW_CONSTEXPR dynamic_view_type drop_back(const size_type item_count) const ARRAY_VIEW_UNCHECKED_NOEXCEPT
+    {
+        ARRAY_VIEW_INSTRUMENT_SLICE(contiguous_view);
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (item_count > size())
+        {
+            ARRAY_VIEW_ERROR("array_view::drop_back(): count is greater than size!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return dynamic_view_type{ m_pointer, size() - item_count };
+    }
+
+    // Compile-time count versions of first() and last(), with a static extent.
+    template<size_type Count>
+    ARRAY_VIEW_CONSTEXPR array_view<value_type, Count> first() const ARRAY_VIEW_UNCHECKED_NOEXCEPT
+    {
+        ARRAY_VIEW_INSTRUMENT_SLICE(contiguous_view);
+        static_assert(Extent == dynamic_extent || Count <= Extent, "array_view::first(): count is greater than size!");
+
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (Count > size())
+        {
+            ARRAY_VIEW_ERROR("array_view::first(): count is greater than size!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return array_view<value_type, Count>{ m_pointer, Count };
+    }
+    template<size_type Count>
+    ARRAY_VIEW_CONSTEXPR array_view<value_type, Count> last() const ARRAY_VIEW_UNCHECKED_NOEXCEPT
+    {
+        ARRAY_VIEW_INSTRUMENT_SLICE(contiguous_view);
+        static_assert(Extent == dynamic_extent || Count <= Extent, "array_view::last(): count is greater than size!");
+
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (Count > size())
+        {
+            ARRAY_VIEW_ERROR("array_view::last(): count is greater than size!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return array_view<value_type, Count>{ m_pointer + (size() - Count), Count };
+    }
+
+    //
+    // Splitting into sub-views for parallel work:
+    //
+
+    // Consecutive slices of chunk_items each (the last one may be shorter).
+    array_view_partitions<value_type> chunks(const size_type chunk_items) const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (chunk_items == 0)
+        {
+            ARRAY_VIEW_ERROR("array_view::chunks() with zero chunk size!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return array_view_partitions<value_type>::make_chunks(*this, chunk_items);
+    }
+
+    // Exactly part_count slices of about the same size, with every inner
+    // boundary moved up to the next alignment_bytes address whenever the
+    // element size allows it, so neighbouring threads don't write to the
+    // same cache line. Parts can be empty if the view is very small.
+    array_view_partitions<value_type> partition_for_threads(const size_type part_count,
+                                                            const size_type alignment_bytes = ARRAY_VIEW_CACHE_LINE_SIZE) const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (part_count == 0)
+        {
+            ARRAY_VIEW_ERROR("array_view::partition_for_threads() with zero parts!");
+        }
+        if (alignment_bytes == 0)
+        {
+            ARRAY_VIEW_ERROR("array_view::partition_for_threads() with zero alignment!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return array_view_partitions<value_type>::make_balanced(*this, part_count, alignment_bytes);
+    }
+
+    //
+    // Bulk stores:
+    //
+
+    // Assigns value to every item. Uses memset when it can, and with
+    // array_view_store_hint::non_temporal streaming stores for large views.
+    template<typename U = T, typename std::enable_if<!std::is_const<U>::value, int>::type = 0>
+    void fill(const value_type & value, const array_view_store_hint hint = array_view_store_hint::normal)
+    {
+        array_view_detail::fill_items(data(), size(), value, hint);
+    }
+
+    // Copies all source items to the start of this view, which must be
+    // at least as big. The ranges must not overlap. memcpy for trivially
+    // copyable types, streaming stores if hinted and large enough.
+    template<typename U = T, typename std::enable_if<!std::is_const<U>::value, int>::type = 0>
+    void copy_from(array_view<const typename std::remove_const<U>::type> source,
+                   const array_view_store_hint hint = array_view_store_hint::normal)
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (source.size() > size())
+        {
+            ARRAY_VIEW_ERROR("array_view::copy_from(): source is bigger than the view!");
+        }
+        check_no_overlap(source.data(), source.size());
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        array_view_detail::copy_items(data(), source.data(), source.size(), hint);
+    }
+
+    // Copies all items of this view to the start of dest, which must be
+    // at least as big. Same rules as copy_from().
+    void copy_to(array_view<typename std::remove_const<value_type>::type> dest,
+                 const array_view_store_hint hint = array_view_store_hint::normal) const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (dest.size() < size())
+        {
+            ARRAY_VIEW_ERROR("array_view::copy_to(): destination is smaller than the view!");
+        }
+        check_no_overlap(dest.data(), dest.size());
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        array_view_detail::copy_items(dest.data(), data(), size(), hint);
+    }
+
+    //
+    // Searching:
+    //
+
+    // Returned by find() and find_first_of() when nothing matches.
+    static constexpr size_type npos = dynamic_extent;
+
+    // Index of the first item equal to value at or after start_index,
+    // or npos. 1, 2 and 4 byte integers and enums are compared with
+    // SSE2/AVX2 (memchr for bytes), other types with operator==.
+    size_type find(const value_type & value, const size_type start_index = 0) const
+    {
+        if (start_index >= size())
+        {
+            return npos;
+        }
+        using item_type = typename std::remove_cv<value_type>::type;
+        const size_type found = array_view_detail::find_items(data() + start_index, size() - start_index, value,
+                                                              array_view_detail::is_simd_searchable<item_type>{});
+        return (found != size() - start_index) ? start_index + found : npos;
+    }
+
+    // Index of the first item at or after start_index that is equal to any item of the set, or npos.
+    size_type find_first_of(array_view<const typename std::remove_cv<value_type>::type> set,
+                            const size_type start_index = 0) const
+    {
+        using item_type = typename std::remove_cv<value_type>::type;
+        if (start_index >= size() || set.empty())
+        {
+            return npos;
+        }
+        const size_type found = array_view_detail::find_first_of_items(data() + start_index, size() - start_index,
+                                                                       set.data(), set.size(),
+                                                                       array_view_detail::is_simd_searchable<item_type>{});
+        return (found != size() - start_index) ? start_index + found : npos;
+    }
+
+    // Number of items equal to value.
+    size_type count(const value_type & value) const
+    {
+        using item_type = typename std::remove_cv<value_type>::type;
+        return array_view_detail::count_items(data(), size(), value,
+                                              array_view_detail::is_simd_searchable<item_type>{});
+    }
+
+    // Lazy range of the sub-views between occurrences of delimiter,
+    // found with find() as the range is iterated. Nothing is allocated.
+    // Empty pieces are kept ("a,,b" gives "a", "", "b") and an empty
+    // view gives no pieces.
+    array_view_split<value_type> split(const value_type & delimiter) const noexcept
+    {
+        return array_view_split<value_type>{ *this, delimiter };
+    }
+
+    //
+    // Data access:
+    //
+
+    ARRAY_VIEW_CONSTEXPR const_reference at(const size_type index) const
+    {
+        // at() always validates the array_view and index.
+        // operator[] uses debug checks that can be disabled if
+        // you care more about performance than runtime checking.
+        ARRAY_VIEW_INSTRUMENT_ACCESS(contiguous_view, index, size());
+        check_not_null();
+        if (index >= size())
+        {
+            ARRAY_VIEW_ERROR("array_view::at(): index is out-of-bounds!");
+        }
+        return *(data() + index);
+    }
+    ARRAY_VIEW_CONSTEXPR reference at(const size_type index)
+    {
+        // Always checked.
+        ARRAY_VIEW_INSTRUMENT_ACCESS(contiguous_view, index, size());
+        check_not_null();
+        if (index >= size())
+        {
+            ARRAY_VIEW_ERROR("array_view::at(): index is out-of-bounds!");
+        }
+        return *(data() + index);
+    }
+
+    ARRAY_VIEW_CONSTEXPR const_reference operator[](const size_type index) const
+    {
+        // Unlike with at() these checks can be disabled for better performance.
+        ARRAY_VIEW_INSTRUMENT_ACCESS(contiguous_view, index, size());
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        check_not_null();
+        if (index >= size())
+        {
+            ARRAY_VIEW_ERROR("array_view::operator[]: index is out-of-bounds!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return *(data() + index);
+    }
+    ARRAY_VIEW_CONSTEXPR reference operator[](const size_type index)
+    {
+        ARRAY_VIEW_INSTRUMENT_ACCESS(contiguous_view, index, size());
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        check_not_null();
+        if (index >= size())
+        {
+            ARRAY_VIEW_ERROR("array_view::operator[]: index is out-of-bounds!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return *(data() + index);
+    }
+
+    //
+    // Begin/end range iterators, front()/back():
+    //
+
+    // forward begin:
+    ARRAY_VIEW_CONSTEXPR iterator begin() noexcept
+    {
+        return make_iterator(0);
+    }
+    ARRAY_VIEW_CONSTEXPR const_iterator begin() const noexcept
+    {
+        return make_const_iterator(0);
+    }
+    ARRAY_VIEW_CONSTEXPR const_iterator cbegin() const noexcept
+    {
+        return make_const_iterator(0);
+    }
+
+    // forward end:
+    ARRAY_VIEW_CONSTEXPR iterator end() noexcept
+    {
+        return make_iterator(size());
+    }
+    ARRAY_VIEW_CONSTEXPR const_iterator end() const noexcept
+    {
+        return make_const_iterator(size());
+    }
+    ARRAY_VIEW_CONSTEXPR const_iterator cend() const noexcept
+    {
+        return make_const_iterator(size());
+    }
+
+    // reverse begin:
+    reverse_iterator rbegin() noexcept
+    {
+        return reverse_iterator{ end() };
+    }
+    const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator{ end() };
+    }
+    const_reverse_iterator crbegin() const noexcept
+    {
+        return const_reverse_iterator{ cend() };
+    }
+
+    // reverse end:
+    reverse_iterator rend() noexcept
+    {
+        return reverse_iterator{ begin() };
+    }
+    const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator{ begin() };
+    }
+    const_reverse_iterator crend() const noexcept
+    {
+        return const_reverse_iterator{ cbegin() };
+    }
+
+    ARRAY_VIEW_CONSTEXPR reference front()
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        check_not_null();
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+        return *data();
+    }
+    ARRAY_VIEW_CONSTEXPR const_reference front() const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        check_not_null();
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+        return *data();
+    }
+
+    ARRAY_VIEW_CONSTEXPR reference back()
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        check_not_null();
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+        return *(data() + size() - 1);
+    }
+    ARRAY_VIEW_CONSTEXPR const_reference back() const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        check_not_null();
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+        return *(data() + size() - 1);
+    }
+
+    //
+    // Miscellaneous queries:
+    //
+
+    constexpr bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+    constexpr size_type size() const noexcept
+    {
+        return extent_storage_type::stored_size();
+    }
+    constexpr size_type size_bytes() const noexcept
+    {
+        return size() * sizeof(value_type);
+    }
+    ARRAY_VIEW_CONSTEXPR const_pointer data() const noexcept
+    {
+        return m_pointer;
+    }
+    ARRAY_VIEW_CONSTEXPR pointer data() noexcept
+    {
+        return m_pointer;
+    }
+
+    //
+    // Compare against nullptr (test for a null array_view):
+    //
+
+    ARRAY_VIEW_CONSTEXPR bool operator == (std::nullptr_t) const noexcept
+    {
+        return data() == nullptr;
+    }
+    ARRAY_VIEW_CONSTEXPR bool operator != (std::nullptr_t) const noexcept
+    {
+        return !(*this == nullptr);
+    }
+
+    // Item comparison with operator == and != is done by the non-member
+    // templates after the class, so static and dynamic extents and
+    // const and mutable items can be mixed in either order.
+
+    //
+    // Compare pointer value for ordering (useful for containers/sorting):
+    //
+
+    ARRAY_VIEW_CONSTEXPR bool operator < (const array_view & other) const noexcept
+    {
+        return data() < other.data();
+    }
+    ARRAY_VIEW_CONSTEXPR bool operator > (const array_view & other) const noexcept
+    {
+        return data() > other.data();
+    }
+    ARRAY_VIEW_CONSTEXPR bool operator <= (const array_view & other) const noexcept
+    {
+        return !(*this > other);
+    }
+    ARRAY_VIEW_CONSTEXPR bool operator >= (const array_view & other) const noexcept
+    {
+        return !(*this < other);
+    }
+
+    //
+    // Non-throwing swap() overload for array_views:
+    //
+
+    friend void swap(array_view & lhs, array_view & rhs) noexcept
+    {
+        using std::swap;
+        swap(lhs.m_pointer, rhs.m_pointer);
+        swap(static_cast<extent_storage_type &>(lhs), static_cast<extent_storage_type &>(rhs));
+    }
+
+private:
+
+    #if ARRAY_VIEW_DEBUG_CHECKS
+    ARRAY_VIEW_CONSTEXPR void check_extent(const size_type size_in_items) const
+    {
+        if (Extent != dynamic_extent && size_in_items != Extent)
+        {
+            ARRAY_VIEW_ERROR("array_view size doesn't match the static extent!");
+        }
+    }
+    #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+    ARRAY_VIEW_CONSTEXPR void check_not_null() const
+    {
+        if (data() == nullptr || empty())
+        {
+            ARRAY_VIEW_ERROR("array_view pointer is null or size is zero!");
+        }
+    }
+
+    #if ARRAY_VIEW_DEBUG_CHECKS
+    void check_no_overlap(const value_type * other, const size_type other_size) const
+    {
+        const auto this_begin  = reinterpret_cast<std::uintptr_t>(data());
+        const auto this_end    = reinterpret_cast<std::uintptr_t>(data() + size());
+        const auto other_begin = reinterpret_cast<std::uintptr_t>(other);
+        const auto other_end   = reinterpret_cast<std::uintptr_t>(other + other_size);
+        if (this_begin < other_end && other_begin < this_end)
+        {
+            ARRAY_VIEW_ERROR("array_view bulk copy between overlapping ranges!");
+        }
+    }
+    #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+    #if ARRAY_VIEW_CHECKED_ITERATORS
+    ARRAY_VIEW_CONSTEXPR iterator make_iterator(const difference_type start_offset) noexcept
+    {
+        return (data() != nullptr) ? iterator{ this, start_offset } : iterator{};
+    }
+
+    ARRAY_VIEW_CONSTEXPR const_iterator make_const_iterator(const difference_type start_offset) const noexcept
+    {
+        return (data() != nullptr) ? const_iterator{ this, start_offset } : const_iterator{};
+    }
+    #else // !ARRAY_VIEW_CHECKED_ITERATORS
+    ARRAY_VIEW_CONSTEXPR iterator make_iterator(const size_type start_offset) noexcept
+    {
+        return data() + start_offset;
+    }
+
+    ARRAY_VIEW_CONSTEXPR const_iterator make_const_iterator(const size_type start_offset) const noexcept
+    {
+        return data() + start_offset;
+    }
+    #endif // ARRAY_VIEW_CHECKED_ITERATORS
+
+    // Pointer is just a reference to external memory. Not owned by array_view.
+    // The item count lives in the extent_storage base (nothing for static extents).
+    pointer m_pointer;
+};
+
+template<typename T, std::size_t Extent>
+constexpr std::size_t array_view<T, Extent>::extent;
+
+template<typename T, std::size_t Extent>
+constexpr std::size_t array_view<T, Extent>::npos;
+
+//
+// Compare for same array pointer and size:
+//
+
+template<typename T, std::size_t LhsExtent, typename U, std::size_t RhsExtent>
+ARRAY_VIEW_CONSTEXPR typename std::enable_if<array_view_detail::same_item_type<T, U>::value, bool>::type
+operator == (const array_view<T, LhsExtent> & lhs, const array_view<U, RhsExtent> & rhs) noexcept
+{
+    // Different sizes, whole sequence can't be identical.
+    if (lhs.size() != rhs.size())
+    {
+        return false;
+    }
+
+    // Pointers to same memory (or both null/empty).
+    if (lhs.data() == rhs.data() || lhs.empty())
+    {
+        return true;
+    }
+
+    // Compare each element, or the raw bytes if that gives the same answer:
+    using item_type = typename std::remove_cv<T>::type;
+    return array_view_detail::equal_items<item_type>(lhs.data(), rhs.data(), lhs.size(),
+                                                     array_view_detail::is_bitwise_comparable<item_type>{});
+}
+template<typename T, std::size_t LhsExtent, typename U, std::size_t RhsExtent>
+ARRAY_VIEW_CONSTEXPR typename std::enable_if<array_view_detail::same_item_type<T, U>::value, bool>::type
+operator != (const array_view<T, LhsExtent> & lhs, const array_view<U, RhsExtent> & rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+// ========================================================
+// template class array_view_partitions:
+// ========================================================
+
+//
+// Lightweight random access range of sub-views returned by
+// array_view::chunks() and array_view::partition_for_threads().
+// Nothing is allocated, part boundaries are computed on access,
+// and iterators can be handed to the parallel Standard algorithms:
+//
+//  auto parts = view.partition_for_threads(num_threads);
+//  std::for_each(std::execution::par, parts.begin(), parts.end(),
+//                [](array_view<float> part) { ... });
+//
+template<typename T>
+class array_view_partitions final
+{
+    // Everything needed to compute a part, copied into the iterators
+    // so that they stay valid after the range object goes away, e.g.
+    // when iterating over a temporary returned by chunks().
+    struct layout
+    {
+        T *         data;
+        std::size_t size;
+        std::size_t part_count;
+        std::size_t chunk_items;     // Nonzero for chunks(), zero for balanced partitions.
+        std::size_t alignment_bytes; // Boundary alignment for balanced partitions.
+    };
+
+public:
+
+    using value_type = array_view<T>;
+    using size_type  = std::size_t;
+
+    class iterator final
+    {
+    public:
+
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = array_view<T>;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = void;
+        using reference         = array_view<T>; // Parts are returned by value.
+
+        iterator() noexcept
+            : m_layout{ nullptr, 0, 0, 0, 1 }
+            , m_index{ 0 }
+        { }
+
+        reference operator*() const { return array_view_partitions::part(m_layout, static_cast<size_type>(m_index)); }
+        reference operator[](const difference_type n) const { return array_view_partitions::part(m_layout, static_cast<size_type>(m_index + n)); }
+
+        iterator & operator++() noexcept { ++m_index; return *this; }
+        iterator & operator--() noexcept { --m_index; return *this; }
+        iterator operator++(int) noexcept { iterator temp{ *this }; ++m_index; return temp; }
+        iterator operator--(int) noexcept { iterator temp{ *this }; --m_index; return temp; }
+
+        iterator & operator += (const difference_type n) noexcept { m_index += n; return *this; }
+        iterator & operator -= (const difference_type n) noexcept { m_index -= n; return *this; }
+        iterator operator + (const difference_type n) const noexcept { return iterator{ m_layout, m_index + n }; }
+        iterator operator - (const difference_type n) const noexcept { return iterator{ m_layout, m_index - n }; }
+        friend iterator operator + (const difference_type n, const iterator & iter) noexcept { return iter + n; }
+        difference_type operator - (const iterator & other) const noexcept { return m_index - other.m_index; }
+
+        bool operator == (const iterator & other) const noexcept { return m_index == other.m_index; }
+        bool operator != (const iterator & other) const noexcept { return m_index != other.m_index; }
+        bool operator <  (const iterator & other) const noexcept { return m_index <  other.m_index; }
+        bool operator >  (const iterator & other) const noexcept { return m_index >  other.m_index; }
+        bool operator <= (const iterator & other) const noexcept { return m_index <= other.m_index; }
+        bool operator >= (const iterator & other) const noexcept { return m_index >= other.m_index; }
+
+    private:
+
+        friend class array_view_partitions;
+
+        iterator(const layout & parts, const difference_type index) noexcept
+            : m_layout{ parts }
+            , m_index{ index }
+        { }
+
+        layout m_layout;
+        difference_type m_index;
+    };
+
+    using const_iterator = iterator;
+
+    static array_view_partitions make_chunks(array_view<T> view, const size_type chunk_items) noexcept
+    {
+        const size_type chunk = (chunk_items != 0) ? chunk_items : 1;
+        return array_view_partitions{ view, (view.size() + chunk - 1) / chunk, chunk, 0 };
+    }
+
+    static array_view_partitions make_balanced(array_view<T> view, const size_type part_count, const size_type alignment_bytes) noexcept
+    {
+        return array_view_partitions{ view, (part_count != 0) ? part_count : 1, 0, (alignment_bytes != 0) ? alignment_bytes : 1 };
+    }
+
+    size_type size() const noexcept { return m_layout.part_count; }
+    bool empty() const noexcept { return m_layout.part_count == 0; }
+
+    iterator begin() const noexcept { return iterator{ m_layout, 0 }; }
+    iterator end()   const noexcept { return iterator{ m_layout, static_cast<std::ptrdiff_t>(m_layout.part_count) }; }
+
+    array_view<T> operator[](const size_type part_index) const
+    {
+        return part(m_layout, part_index);
+    }
+
+    // Item offset where part_index starts in the original view.
+    size_type boundary(const size_type part_index) const noexcept
+    {
+        return boundary(m_layout, part_index);
+    }
+
+private:
+
+    array_view_partitions(array_view<T> view, const size_type part_count,
+                          const size_type chunk_items, const size_type alignment_bytes) noexcept
+        : m_layout{ view.data(), view.size(), part_count, chunk_items, alignment_bytes }
+    { }
+
+    static array_view<T> part(const layout & parts, const size_type part_index)
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (part_index >= parts.part_count)
+        {
+            ARRAY_VIEW_ERROR("array_view_partitions::operator[]: part index is out-of-bounds!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        const size_type first = boundary(parts, part_index);
+        const size_type last  = boundary(parts, part_index + 1);
+        return array_view<T>{ parts.data + first, last - first };
+    }
+
+    static size_type boundary(const layout & parts, const size_type part_index) noexcept
+    {
+        const size_type total = parts.size;
+        if (part_index >= parts.part_count)
+        {
+            return total;
+        }
+        if (parts.chunk_items != 0)
+        {
+            return part_index * parts.chunk_items;
+        }
+        if (part_index == 0)
+        {
+            return 0;
+        }
+
+        // Even split (written to avoid overflowing part_index * total),
+        // then rounded up to the next aligned element.
+        size_type offset = (total / parts.part_count) * part_index + ((total % parts.part_count) * part_index) / parts.part_count;
+
+        const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(parts.data + offset);
+        const size_type misalignment = static_cast<size_type>(address % parts.alignment_bytes);
+        if (misalignment != 0 && (parts.alignment_bytes - misalignment) % sizeof(T) == 0)
+        {
+            offset += (parts.alignment_bytes - misalignment) / sizeof(T);
+        }
+        return (offset < total) ? offset : total;
+    }
+
+    layout m_layout;
+};
+
+// ========================================================
+// template class array_view_split:
+// ========================================================
+
+//
+// Forward range of the pieces of a view between delimiter items,
+// returned by array_view::split(). Each step is one find() call
+// and pieces are sub-views of the original, so parsing a line
+// allocates nothing:
+//
+//  for (array_view<const char> field : line.split(','))
+//  {
+//      ...
+//  }
+//
+template<typename T>
+class array_view_split final
+{
+public:
+
+    using value_type = array_view<T>;
+    using size_type  = std::size_t;
+
+    class iterator final
+    {
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = array_view<T>;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = void;
+        using reference         = array_view<T>; // Pieces are returned by value.
+
+        iterator()
+            : m_view{}
+            , m_delimiter{}
+            , m_first{ array_view<T>::npos }
+            , m_last{ array_view<T>::npos }
+        { }
+
+        reference operator*() const
+        {
+            return m_view.slice(m_first, m_last - m_first);
+        }
+
+        iterator & operator++()
+        {
+            // The piece ended at a delimiter if it didn't reach the end of the view.
+            if (m_last == m_view.size())
+            {
+                m_first = m_last = array_view<T>::npos;
+            }
+            else
+            {
+                m_first = m_last + 1;
+                m_last  = piece_end(m_first);
+            }
+            return *this;
+        }
+        iterator operator++(int)
+        {
+            iterator temp{ *this };
+            ++(*this);
+            return temp;
+        }
+
+        bool operator == (const iterator & other) const noexcept { return m_first == other.m_first; }
+        bool operator != (const iterator & other) const noexcept { return m_first != other.m_first; }
+
+    private:
+
+        friend class array_view_split;
+
+        // The view and delimiter are copied, not referenced through the
+        // range, so iterators outlive a temporary returned by split().
+        iterator(array_view<T> view, const T & delimiter, const size_type first)
+            : m_view{ view }
+            , m_delimiter{ delimiter }
+            , m_first{ first }
+            , m_last{ (first != array_view<T>::npos) ? piece_end(first) : array_view<T>::npos }
+        { }
+
+        size_type piece_end(const size_type first) const
+        {
+            const size_type delimiter_index = m_view.find(m_delimiter, first);
+            return (delimiter_index != array_view<T>::npos) ? delimiter_index : m_view.size();
+        }
+
+        array_view<T> m_view;
+        typename std::remove_cv<T>::type m_delimiter;
+        size_type m_first; // npos once past the last piece.
+        size_type m_last;
+    };
+
+    using const_iterator = iterator;
+
+    array_view_split(array_view<T> view, const T & delimiter) noexcept
+        : m_view{ view }
+        , m_delimiter{ delimiter }
+    { }
+
+    iterator begin() const { return iterator{ m_view, m_delimiter, m_view.empty() ? array_view<T>::npos : 0 }; }
+    iterator end()   const { return iterator{ m_view, m_delimiter, array_view<T>::npos }; }
+
+private:
+
+    array_view<T> m_view;
+    typename std::remove_cv<T>::type m_delimiter;
+};
+
+//
+// make_array_view() helpers:
+//
+template<typename ArrayType, std::size_t ArraySize>
+constexpr array_view<ArrayType> make_array_view(ArrayType (&arr)[ArraySize]) noexcept
+{
+    return { arr, ArraySize };
+}
+template<typename ArrayType>
+ARRAY_VIEW_CONSTEXPR array_view<ArrayType> make_array_view(ArrayType * array_ptr, const std::size_t size_in_items) noexcept
+{
+    return { array_ptr, size_in_items };
+}
+template<typename ContainerType>
+ARRAY_VIEW_CONSTEXPR array_view<typename std::remove_pointer<decltype(std::declval<ContainerType &>().data())>::type>
+make_array_view(ContainerType & container) noexcept
+{
+    // Element type taken from data() so const containers give views of const.
+    return array_view<typename std::remove_pointer<decltype(std::declval<ContainerType &>().data())>::type>{ container };
+}
+
+//
+// make_static_array_view(): same as make_array_view() for
+// C-style arrays, but the resulting view has a static extent.
+//
+template<typename ArrayType, std::size_t ArraySize>
+constexpr array_view<ArrayType, ArraySize> make_static_array_view(ArrayType (&arr)[ArraySize]) noexcept
+{
+    return array_view<ArrayType, ArraySize>{ arr };
+}
+
+// ========================================================
+// array_view byte reinterpretation:
+// ========================================================
+
+namespace array_view_detail
+{
+    template<typename T, std::size_t Extent>
+    struct bytes_extent
+    {
+        static constexpr std::size_t value = (Extent == dynamic_extent) ? dynamic_extent : Extent * sizeof(T);
+    };
+
+    // Debug validation shared by view_cast() and make_strided_array_view().
+    inline void check_cast_alignment(const void * ptr, const std::size_t alignment, const char * message)
+    {
+        if ((reinterpret_cast<std::uintptr_t>(ptr) & (alignment - 1)) != 0)
+        {
+            ARRAY_VIEW_ERROR(message);
+        }
+    }
+} // namespace array_view_detail {}
+
+//
+// as_bytes() / as_writable_bytes(): the object representation of
+// the viewed items, as a view of bytes with size() == size_bytes().
+// Static extents stay static (Extent * sizeof(T)).
+//
+template<typename T, std::size_t Extent>
+array_view<const std::uint8_t, array_view_detail::bytes_extent<T, Extent>::value> as_bytes(array_view<T, Extent> view) noexcept
+{
+    return array_view<const std::uint8_t, array_view_detail::bytes_extent<T, Extent>::value>{
+        reinterpret_cast<const std::uint8_t *>(view.data()), view.size_bytes() };
+}
+
+template<typename T, std::size_t Extent, typename std::enable_if<!std::is_const<T>::value, int>::type = 0>
+array_view<std::uint8_t, array_view_detail::bytes_extent<T, Extent>::value> as_writable_bytes(array_view<T, Extent> view) noexcept
+{
+    return array_view<std::uint8_t, array_view_detail::bytes_extent<T, Extent>::value>{
+        reinterpret_cast<std::uint8_t *>(view.data()), view.size_bytes() };
+}
+
+//
+// view_cast<U>(): reinterprets the memory of an array_view<T> as items
+// of type U, e.g. a wire buffer of bytes as an array of records, without
+// copying. U must be const if T is. With ARRAY_VIEW_DEBUG_CHECKS the byte
+// size is validated to be a multiple of sizeof(U) and data() to be aligned
+// for U. Only meaningful for trivially copyable types.
+//
+//  array_view<const std::uint8_t> packet = ...;
+//  auto records = view_cast<const Record>(packet);
+//
+template<typename U, typename T, std::size_t Extent>
+array_view<U> view_cast(array_view<T, Extent> view) ARRAY_VIEW_UNCHECKED_NOEXCEPT
+{
+    static_assert(std::is_const<U>::value || !std::is_const<T>::value,
+                  "view_cast() can't cast away const!");
+    static_assert(std::is_trivially_copyable<typename std::remove_const<U>::type>::value,
+                  "view_cast() target type must be trivially copyable!");
+
+    #if ARRAY_VIEW_DEBUG_CHECKS
+    if (view.size_bytes() % sizeof(U) != 0)
+    {
+        ARRAY_VIEW_ERROR("view_cast(): size in bytes is not a multiple of the target type size!");
+    }
+    array_view_detail::check_cast_alignment(view.data(), alignof(U), "view_cast(): data is misaligned for the target type!");
+    #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+    using byte_type = typename std::conditional<std::is_const<T>::value, const std::uint8_t, std::uint8_t>::type;
+    return array_view<U>{ reinterpret_cast<U *>(reinterpret_cast<byte_type *>(view.data())), view.size_bytes() / sizeof(U) };
+}
+
+// ========================================================
+// template class aligned_array_view:
+// ========================================================
+
+namespace array_view_detail
+{
+    // Tells the optimizer that ptr is a multiple of Alignment, so loops
+    // over it can skip the peeling prologue and use aligned loads.
+    // A no-op on compilers with neither builtin.
+    template<std::size_t Alignment, typename T>
+    inline T * assume_aligned(T * ptr) noexcept
+    {
+        #if defined(__GNUC__) || defined(__clang__)
+        return static_cast<T *>(__builtin_assume_aligned(ptr, Alignment));
+        #elif defined(_MSC_VER)
+        __assume((reinterpret_cast<std::uintptr_t>(ptr) & (Alignment - 1)) == 0);
+        return ptr;
+        #else // Unknown compiler
+        return ptr;
+        #endif // __GNUC__ || __clang__ || _MSC_VER
+    }
+
+    // Largest power of two dividing ByteOffset, capped to Alignment.
+    // That's the alignment left after advancing an Alignment-aligned
+    // pointer by ByteOffset bytes. Zero offset keeps Alignment.
+    template<std::size_t Alignment, std::size_t ByteOffset>
+    struct offset_alignment
+    {
+        static constexpr std::size_t low_bit = ByteOffset & (~ByteOffset + 1);
+        static constexpr std::size_t value   = (ByteOffset == 0 || low_bit >= Alignment) ? Alignment : low_bit;
+    };
+} // namespace array_view_detail {}
+
+//
+// array_view<T> whose data() is known to be aligned to Alignment bytes.
+// The address is validated on construction with ARRAY_VIEW_DEBUG_CHECKS,
+// and data() + the release iterators pass it on to the optimizer with
+// __builtin_assume_aligned (or __assume on MSVC). The alignment is part
+// of the type, so kernels can require it in their signatures:
+//
+//  void score(aligned_array_view<const float, 64> weights);
+//
+// Runtime slice() returns a plain array_view since an arbitrary offset
+// loses the guarantee. slice<Offset>() keeps whatever alignment is left
+// after Offset items, and aligned_slice() keeps all of it, with the
+// offset validated by ARRAY_VIEW_DEBUG_CHECKS.
+//
+template
+<
+    typename T,
+    std::size_t Alignment
+>
+class aligned_array_view final
+{
+    static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0,
+                  "aligned_array_view alignment must be a power of two!");
+    static_assert(Alignment >= alignof(T),
+                  "aligned_array_view alignment is less than the natural alignment of T!");
+
+public:
+
+    //
+    // Nested types:
+    //
+
+    using view_type              = array_view<T>;
+    using value_type             = typename view_type::value_type;
+    using size_type              = typename view_type::size_type;
+    using difference_type        = typename view_type::difference_type;
+
+    using pointer                = typename view_type::pointer;
+    using reference              = typename view_type::reference;
+    using const_pointer          = typename view_type::const_pointer;
+    using const_reference        = typename view_type::const_reference;
+
+    using iterator               = typename view_type::iterator;
+    using const_iterator         = typename view_type::const_iterator;
+    using reverse_iterator       = typename view_type::reverse_iterator;
+    using const_reverse_iterator = typename view_type::const_reverse_iterator;
+
+    static constexpr size_type alignment = Alignment;
+
+    //
+    // Constructors / assignment:
+    //
+
+    aligned_array_view() noexcept = default;
+
+    template<typename ConvertibleType>
+    aligned_array_view(ConvertibleType * array_ptr, const size_type size_in_items) ARRAY_VIEW_UNCHECKED_NOEXCEPT
+        : m_view{ array_ptr, size_in_items }
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        check_alignment(m_view.data());
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+    }
+
+    // Adopting an unaligned-typed view must be spelled out.
+    template<typename ConvertibleType, std::size_t Extent>
+    explicit aligned_array_view(array_view<ConvertibleType, Extent> view) ARRAY_VIEW_UNCHECKED_NOEXCEPT
+        : m_view{ view }
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        check_alignment(m_view.data());
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+    }
+
+    // U to const U, and stronger to weaker alignments.
+    template
+    <
+        typename ConvertibleType,
+        std::size_t OtherAlignment,
+        typename std::enable_if<(OtherAlignment >= Alignment), int>::type = 0
+    >
+    aligned_array_view(aligned_array_view<ConvertibleType, OtherAlignment> other) noexcept
+        : m_view{ other.as_array_view() }
+    { }
+
+    // Aligned views decay to plain array_views implicitly.
+    template<typename ConvertibleType, typename std::enable_if<std::is_convertible<pointer, ConvertibleType *>::value, int>::type = 0>
+    operator array_view<ConvertibleType>() const noexcept
+    {
+        return array_view<ConvertibleType>{ m_view.data(), m_view.size() };
+    }
+
+    view_type as_array_view() const noexcept
+    {
+        return m_view;
+    }
+
+    //
+    // Sub-views:
+    //
+
+    // Arbitrary offsets don't preserve the alignment.
+    array_view<value_type> slice(const size_type offset_in_items) const
+    {
+        return m_view.slice(offset_in_items);
+    }
+    array_view<value_type> slice(const size_type offset_in_items, const size_type item_count) const
+    {
+        return m_view.slice(offset_in_items, item_count);
+    }
+
+    // Offset known at compile-time. The result keeps the alignment
+    // remaining after Offset items, e.g. slice<4>() of a 64-byte
+    // aligned float view is 16-byte aligned, slice<16>() 64-byte aligned.
+    template<size_type Offset, size_type Count = dynamic_extent>
+    aligned_array_view<value_type, array_view_detail::offset_alignment<Alignment, Offset * sizeof(value_type)>::value> slice() const
+    {
+        return aligned_array_view<value_type, array_view_detail::offset_alignment<Alignment, Offset * sizeof(value_type)>::value>{
+            m_view.template slice<Offset, Count>() };
+    }
+
+    // Same alignment as the source. offset_in_items * sizeof(T) must be
+    // a multiple of Alignment, which is validated by ARRAY_VIEW_DEBUG_CHECKS.
+    aligned_array_view aligned_slice(const size_type offset_in_items, const size_type item_count) const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if ((offset_in_items * sizeof(value_type)) % Alignment != 0)
+        {
+            ARRAY_VIEW_ERROR("aligned_array_view::aligned_slice(): offset breaks the alignment!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return aligned_array_view{ m_view.slice(offset_in_items, item_count) };
+    }
+
+    //
+    // Data access:
+    //
+
+    const_reference at(const size_type index) const { return m_view.at(index); }
+    reference at(const size_type index) { return m_view.at(index); }
+
+    const_reference operator[](const size_type index) const { return m_view[index]; }
+    reference operator[](const size_type index) { return m_view[index]; }
+
+    const_reference front() const { return m_view.front(); }
+    reference front() { return m_view.front(); }
+
+    const_reference back() const { return m_view.back(); }
+    reference back() { return m_view.back(); }
+
+    //
+    // Begin/end range iterators:
+    //
+
+    iterator begin() noexcept { return assume_aligned_iterator(m_view.begin()); }
+    const_iterator begin() const noexcept { return assume_aligned_iterator(m_view.begin()); }
+    const_iterator cbegin() const noexcept { return assume_aligned_iterator(m_view.cbegin()); }
+
+    iterator end() noexcept { return m_view.end(); }
+    const_iterator end() const noexcept { return m_view.end(); }
+    const_iterator cend() const noexcept { return m_view.cend(); }
+
+    reverse_iterator rbegin() noexcept { return reverse_iterator{ end() }; }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{ end() }; }
+    const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator{ cend() }; }
+
+    reverse_iterator rend() noexcept { return reverse_iterator{ begin() }; }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator{ begin() }; }
+    const_reverse_iterator crend() const noexcept { return const_reverse_iterator{ cbegin() }; }
+
+    //
+    // Miscellaneous queries:
+    //
+
+    bool empty() const noexcept { return m_view.empty(); }
+    size_type size() const noexcept { return m_view.size(); }
+    size_type size_bytes() const noexcept { return m_view.size_bytes(); }
+
+    const_pointer data() const noexcept
+    {
+        return array_view_detail::assume_aligned<Alignment>(m_view.data());
+    }
+    pointer data() noexcept
+    {
+        return array_view_detail::assume_aligned<Alignment>(m_view.data());
+    }
+
+    bool operator == (std::nullptr_t) const noexcept { return m_view == nullptr; }
+    bool operator != (std::nullptr_t) const noexcept { return m_view != nullptr; }
+
+    friend void swap(aligned_array_view & lhs, aligned_array_view & rhs) noexcept
+    {
+        swap(lhs.m_view, rhs.m_view);
+    }
+
+private:
+
+    #if ARRAY_VIEW_DEBUG_CHECKS
+    static void check_alignment(const void * ptr)
+    {
+        if ((reinterpret_cast<std::uintptr_t>(ptr) & (Alignment - 1)) != 0)
+        {
+            ARRAY_VIEW_ERROR("aligned_array_view pointer is not aligned!");
+        }
+    }
+    #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+    // Release iterators are pointers and carry the alignment too,
+    // the checked iterators are returned unchanged.
+    template<typename IterType>
+    static IterType assume_aligned_iterator(IterType iter) noexcept
+    {
+        #if ARRAY_VIEW_CHECKED_ITERATORS
+        return iter;
+        #else // !ARRAY_VIEW_CHECKED_ITERATORS
+        return array_view_detail::assume_aligned<Alignment>(iter);
+        #endif // ARRAY_VIEW_CHECKED_ITERATORS
+    }
+
+    view_type m_view;
+};
+
+template<typename T, std::size_t Alignment>
+constexpr typename aligned_array_view<T, Alignment>::size_type aligned_array_view<T, Alignment>::alignment;
+
+//
+// make_aligned_array_view<Alignment>(): same as make_array_view(),
+// plus the alignment check with ARRAY_VIEW_DEBUG_CHECKS.
+//
+template<std::size_t Alignment, typename ArrayType>
+aligned_array_view<ArrayType, Alignment> make_aligned_array_view(ArrayType * array_ptr, const std::size_t size_in_items) ARRAY_VIEW_UNCHECKED_NOEXCEPT
+{
+    return aligned_array_view<ArrayType, Alignment>{ array_ptr, size_in_items };
+}
+template<std::size_t Alignment, typename ContainerType>
+auto make_aligned_array_view(ContainerType & container) ARRAY_VIEW_UNCHECKED_NOEXCEPT
+    -> aligned_array_view<typename std::remove_pointer<decltype(make_array_view(container).data())>::type, Alignment>
+{
+    return aligned_array_view<typename std::remove_pointer<decltype(make_array_view(container).data())>::type, Alignment>{ make_array_view(container) };
+}
+
+// ========================================================
+// array_view content hashing:
+// ========================================================
+
+//
+// Streaming 64-bit hash of array_view contents (the XXH64 algorithm).
+// Feeding a sequence in several update() calls gives the same digest
+// as hashing it in one go, so a key split across slices can be hashed
+// with no copying. Only types accepted by the memcmp path of
+// array_view::operator== can be hashed, to keep hashing consistent
+// with equality.
+//
+class array_view_hasher final
+{
+public:
+
+    explicit array_view_hasher(const std::uint64_t seed = 0) noexcept
+    {
+        reset(seed);
+    }
+
+    void reset(const std::uint64_t seed = 0) noexcept
+    {
+        m_acc[0] = seed + prime1 + prime2;
+        m_acc[1] = seed + prime2;
+        m_acc[2] = seed;
+        m_acc[3] = seed - prime1;
+        m_seed = seed;
+        m_total_len = 0;
+        m_buffered = 0;
+    }
+
+    template<typename T, std::size_t Extent>
+    array_view_hasher & update(const array_view<T, Extent> & view) noexcept
+    {
+        static_assert(array_view_detail::is_bitwise_comparable<typename std::remove_cv<T>::type>::value,
+                      "array_view_hasher only hashes types that compare equal bitwise!");
+        return update_bytes(view.data(), view.size_bytes());
+    }
+
+    array_view_hasher & update_bytes(const void * bytes, const std::size_t size_in_bytes) noexcept
+    {
+        if (size_in_bytes == 0)
+        {
+            return *this;
+        }
+
+        const std::uint8_t * input = static_cast<const std::uint8_t *>(bytes);
+        const std::uint8_t * const input_end = input + size_in_bytes;
+        m_total_len += size_in_bytes;
+
+        // Not enough for a full stripe yet.
+        if (m_buffered + size_in_bytes < stripe_size)
+        {
+            std::memcpy(m_buffer + m_buffered, input, size_in_bytes);
+            m_buffered += size_in_bytes;
+            return *this;
+        }
+
+        // Complete the stripe left over from the previous update.
+        if (m_buffered != 0)
+        {
+            const std::size_t fill = stripe_size - m_buffered;
+            std::memcpy(m_buffer + m_buffered, input, fill);
+            consume_stripe(m_buffer);
+            input += fill;
+            m_buffered = 0;
+        }
+
+        while (input_end - input >= static_cast<std::ptrdiff_t>(stripe_size))
+        {
+            consume_stripe(input);
+            input += stripe_size;
+        }
+
+        m_buffered = static_cast<std::size_t>(input_end - input);
+        if (m_buffered != 0)
+        {
+            std::memcpy(m_buffer, input, m_buffered);
+        }
+        return *this;
+    }
+
+    std::uint64_t digest() const noexcept
+    {
+        std::uint64_t h;
+        if (m_total_len >= stripe_size)
+        {
+            h = rotl(m_acc[0], 1) + rotl(m_acc[1], 7) + rotl(m_acc[2], 12) + rotl(m_acc[3], 18);
+            h = merge_round(h, m_acc[0]);
+            h = merge_round(h, m_acc[1]);
+            h = merge_round(h, m_acc[2]);
+            h = merge_round(h, m_acc[3]);
+        }
+        else
+        {
+            h = m_seed + prime5;
+        }
+
+        h += m_total_len;
+
+        const std::uint8_t * p = m_buffer;
+        std::size_t remaining = m_buffered;
+        for (; remaining >= 8; remaining -= 8, p += 8)
+        {
+            h ^= round(0, read64(p));
+            h  = rotl(h, 27) * prime1 + prime4;
+        }
+        if (remaining >= 4)
+        {
+            h ^= static_cast<std::uint64_t>(read32(p)) * prime1;
+            h  = rotl(h, 23) * prime2 + prime3;
+            remaining -= 4;
+            p += 4;
+        }
+        for (; remaining != 0; --remaining, ++p)
+        {
+            h ^= (*p) * prime5;
+            h  = rotl(h, 11) * prime1;
+        }
+
+        // Final avalanche.
+        h ^= h >> 33;
+        h *= prime2;
+        h ^= h >> 29;
+        h *= prime3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    // One-shot helper.
+    template<typename T, std::size_t Extent>
+    static std::uint64_t hash(const array_view<T, Extent> & view, const std::uint64_t seed = 0) noexcept
+    {
+        return array_view_hasher{ seed }.update(view).digest();
+    }
+
+private:
+
+    static constexpr std::uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+    static constexpr std::uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr std::uint64_t prime3 = 0x165667B19E3779F9ULL;
+    static constexpr std::uint64_t prime4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr std::uint64_t prime5 = 0x27D4EB2F165667C5ULL;
+    static constexpr std::size_t stripe_size = 32;
+
+    static std::uint64_t rotl(const std::uint64_t x, const int r) noexcept
+    {
+        return (x << r) | (x >> (64 - r));
+    }
+    static std::uint64_t read64(const std::uint8_t * p) noexcept
+    {
+        std::uint64_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    static std::uint32_t read32(const std::uint8_t * p) noexcept
+    {
+        std::uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    static std::uint64_t round(std::uint64_t acc, const std::uint64_t input) noexcept
+    {
+        acc += input * prime2;
+        acc  = rotl(acc, 31);
+        acc *= prime1;
+        return acc;
+    }
+    static std::uint64_t merge_round(std::uint64_t acc, const std::uint64_t value) noexcept
+    {
+        acc ^= round(0, value);
+        acc  = acc * prime1 + prime4;
+        return acc;
+    }
+
+    void consume_stripe(const std::uint8_t * stripe) noexcept
+    {
+        m_acc[0] = round(m_acc[0], read64(stripe +  0));
+        m_acc[1] = round(m_acc[1], read64(stripe +  8));
+        m_acc[2] = round(m_acc[2], read64(stripe + 16));
+        m_acc[3] = round(m_acc[3], read64(stripe + 24));
+    }
+
+    std::uint64_t m_acc[4];
+    std::uint64_t m_seed;
+    std::uint64_t m_total_len;
+    std::size_t   m_buffered;
+    std::uint8_t  m_buffer[stripe_size];
+};
+
+//
+// Hash functor for unordered containers keyed by array_view contents.
+// Pair it with the default std::equal_to (array_view::operator==).
+//
+struct array_view_hash final
+{
+    template<typename T, std::size_t Extent>
+    std::size_t operator()(const array_view<T, Extent> & view) const noexcept
+    {
+        return static_cast<std::size_t>(array_view_hasher::hash(view));
+    }
+};
+
+// std::hash can't be specialized when this file is placed inside
+// a user namespace (ARRAY_VIEW_NO_STD_INCLUDES), use array_view_hash then.
+#ifndef ARRAY_VIEW_NO_STD_INCLUDES
+namespace std
+{
+    template<typename T, std::size_t Extent>
+    struct hash<array_view<T, Extent>>
+    {
+        std::size_t operator()(const array_view<T, Extent> & view) const noexcept
+        {
+            return array_view_hash{}(view);
+        }
+    };
+} // namespace std {}
+#endif // ARRAY_VIEW_NO_STD_INCLUDES
+
+// ========================================================
+// template class strided_array_iterator:
+// ========================================================
+
+//
+// Random access iterator for strided_array_view.
+// Holds a byte pointer to the start of the current structure,
+// so stepping is a single add of StrideBytes and dereferencing
+// folds OffsetBytes into the address. It doesn't reference the
+// view it came from, so it can be freely copied between threads
+// and used with the parallel Standard algorithms.
+//
+// With OffsetBytes and StrideBytes = dynamic_extent the
+// layout is carried at runtime (see dynamic_strided_array_view).
+//
+template
+<
+    typename T,
+    std::size_t OffsetBytes,
+    std::size_t StrideBytes
+>
+class strided_array_iterator final
+    : private array_view_detail::stride_storage<OffsetBytes, StrideBytes>
+{
+public:
+
+    //
+    // Nested types:
+    //
+
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type        = typename std::remove_cv<T>::type;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = typename std::add_pointer<T>::type;
+    using reference         = typename std::add_lvalue_reference<T>::type;
+
+    using byte_type         = typename std::conditional<std::is_const<T>::value, const std::uint8_t, std::uint8_t>::type;
+    using byte_ptr_type     = typename std::add_pointer<byte_type>::type;
+    using stride_storage_type = array_view_detail::stride_storage<OffsetBytes, StrideBytes>;
+
+    //
+    // Constructors / assignment:
+    //
+
+    ARRAY_VIEW_CONSTEXPR strided_array_iterator() noexcept
+        : m_item_ptr{ nullptr }
+    { }
+
+    ARRAY_VIEW_CONSTEXPR explicit strided_array_iterator(byte_ptr_type item_ptr, const stride_storage_type & layout = stride_storage_type{}) noexcept
+        : stride_storage_type{ layout }
+        , m_item_ptr{ item_ptr }
+    { }
+
+    using stride_storage_type::offset_bytes;
+    using stride_storage_type::stride_bytes;
+
+    //
+    // Pointer-emulation operator overloads:
+    //
+
+    ARRAY_VIEW_CONSTEXPR difference_type operator - (const strided_array_iterator & other) const noexcept
+    {
+        return array_view_detail::stride_distance<StrideBytes>(m_item_ptr - other.m_item_ptr, signed_stride());
+    }
+
+    ARRAY_VIEW_CONSTEXPR strided_array_iterator operator + (const difference_type displacement) const noexcept
+    {
+        return strided_array_iterator{ m_item_ptr + displacement * signed_stride(), layout() };
+    }
+    ARRAY_VIEW_CONSTEXPR strided_array_iterator operator - (const difference_type displacement) const noexcept
+    {
+        return strided_array_iterator{ m_item_ptr - displacement * signed_stride(), layout() };
+    }
+    friend strided_array_iterator operator + (const difference_type displacement, const strided_array_iterator & iter) noexcept
+    {
+        return iter + displacement;
+    }
+
+    ARRAY_VIEW_CONSTEXPR strided_array_iterator & operator += (const difference_type displacement) noexcept
+    {
+        ARRAY_VIEW_INSTRUMENT_STEPS(strided_view, array_view_detail::step_count(displacement));
+        m_item_ptr += displacement * signed_stride();
+        return *this;
+    }
+    ARRAY_VIEW_CONSTEXPR strided_array_iterator & operator -= (const difference_type displacement) noexcept
+    {
+        ARRAY_VIEW_INSTRUMENT_STEPS(strided_view, array_view_detail::step_count(displacement));
+        m_item_ptr -= displacement * signed_stride();
+        return *this;
+    }
+
+    ARRAY_VIEW_CONSTEXPR strided_array_iterator & operator++() noexcept // pre-increment
+    {
+        ARRAY_VIEW_INSTRUMENT_STEPS(strided_view, 1);
+        m_item_ptr += stride_bytes();
+        return *this;
+    }
+    ARRAY_VIEW_CONSTEXPR strided_array_iterator operator++(int) noexcept // post-increment
+    {
+        strided_array_iterator temp{ *this };
+        ARRAY_VIEW_INSTRUMENT_STEPS(strided_view, 1);
+        m_item_ptr += stride_bytes();
+        return temp;
+    }
+
+    ARRAY_VIEW_CONSTEXPR strided_array_iterator & operator--() noexcept // pre-decrement
+    {
+        ARRAY_VIEW_INSTRUMENT_STEPS(strided_view, 1);
+        m_item_ptr -= stride_bytes();
+        return *this;
+    }
+    ARRAY_VIEW_CONSTEXPR strided_array_iterator operator--(int) noexcept // post-decrement
+    {
+        strided_array_iterator temp{ *this };
+        ARRAY_VIEW_INSTRUMENT_STEPS(strided_view, 1);
+        m_item_ptr -= stride_bytes();
+        return temp;
+    }
+
+    reference operator*() const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (m_item_ptr == nullptr)
+        {
+            ARRAY_VIEW_ERROR("strided_array_iterator::operator*: iterator not dereferenceable!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return *reinterpret_cast<pointer>(m_item_ptr + offset_bytes());
+    }
+    pointer operator->() const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (m_item_ptr == nullptr)
+        {
+            ARRAY_VIEW_ERROR("strided_array_iterator::operator->: iterator not dereferenceable!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return reinterpret_cast<pointer>(m_item_ptr + offset_bytes());
+    }
+    reference operator[](const difference_type index) const
+    {
+        return *(*this + index);
+    }
+
+    // Comparisons are non-member templates (after the class),
+    // so mutable and const iterators compare in either order.
+
+    //
+    // One way conversion from mutable iterator to const iterator:
+    //
+
+    ARRAY_VIEW_CONSTEXPR operator strided_array_iterator<const T, OffsetBytes, StrideBytes>() const noexcept
+    {
+        return strided_array_iterator<const T, OffsetBytes, StrideBytes>{ m_item_ptr, layout() };
+    }
+
+    // Address of the structure (not the member) the iterator is currently at.
+    ARRAY_VIEW_CONSTEXPR byte_ptr_type get_item_base_ptr() const noexcept
+    {
+        return m_item_ptr;
+    }
+
+    //
+    // Non-throwing swap() overload for strided_array_iterator:
+    //
+
+    friend void swap(strided_array_iterator & lhs, strided_array_iterator & rhs) noexcept
+    {
+        using std::swap;
+        swap(lhs.m_item_ptr, rhs.m_item_ptr);
+        swap(static_cast<stride_storage_type &>(lhs), static_cast<stride_storage_type &>(rhs));
+    }
+
+private:
+
+    constexpr const stride_storage_type & layout() const noexcept
+    {
+        return *this;
+    }
+
+    ARRAY_VIEW_CONSTEXPR difference_type signed_stride() const noexcept
+    {
+        return static_cast<difference_type>(stride_bytes());
+    }
+
+    // Start of the current structure. OffsetBytes
+    // is only added when dereferencing.
+    byte_ptr_type m_item_ptr;
+};
+
+//
+// strided_array_iterator comparison operators:
+//
+
+template<typename T, typename U, std::size_t OffsetBytes, std::size_t StrideBytes>
+ARRAY_VIEW_CONSTEXPR typename std::enable_if<array_view_detail::same_item_type<T, U>::value, bool>::type
+operator == (const strided_array_iterator<T, OffsetBytes, StrideBytes> & lhs,
+            const strided_array_iterator<U, OffsetBytes, StrideBytes> & rhs) noexcept
+{
+    return lhs.get_item_base_ptr() == rhs.get_item_base_ptr();
+}
+template<typename T, typename U, std::size_t OffsetBytes, std::size_t StrideBytes>
+ARRAY_VIEW_CONSTEXPR typename std::enable_if<array_view_detail::same_item_type<T, U>::value, bool>::type
+operator != (const strided_array_iterator<T, OffsetBytes, StrideBytes> & lhs,
+            const strided_array_iterator<U, OffsetBytes, StrideBytes> & rhs) noexcept
+{
+    return lhs.get_item_base_ptr() != rhs.get_item_base_ptr();
+}
+template<typename T, typename U, std::size_t OffsetBytes, std::size_t StrideBytes>
+ARRAY_VIEW_CONSTEXPR typename std::enable_if<array_view_detail::same_item_type<T, U>::value, bool>::type
+operator <  (const strided_array_iterator<T, OffsetBytes, StrideBytes> & lhs,
+            const strided_array_iterator<U, OffsetBytes, StrideBytes> & rhs) noexcept
+{
+    return lhs.get_item_base_ptr() < rhs.get_item_base_ptr();
+}
+template<typename T, typename U, std::size_t OffsetBytes, std::size_t StrideBytes>
+ARRAY_VIEW_CONSTEXPR typename std::enable_if<array_view_detail::same_item_type<T, U>::value, bool>::type
+operator >  (const strided_array_iterator<T, OffsetBytes, StrideBytes> & lhs,
+            const strided_array_iterator<U, OffsetBytes, StrideBytes> & rhs) noexcept
+{
+    return lhs.get_item_base_ptr() > rhs.get_item_base_ptr();
+}
+template<typename T, typename U, std::size_t OffsetBytes, std::size_t StrideBytes>
+ARRAY_VIEW_CONSTEXPR typename std::enable_if<array_view_detail::same_item_type<T, U>::value, bool>::type
+operator <= (const strided_array_iterator<T, OffsetBytes, StrideBytes> & lhs,
+            const strided_array_iterator<U, OffsetBytes, StrideBytes> & rhs) noexcept
+{
+    return lhs.get_item_base_ptr() <= rhs.get_item_base_ptr();
+}
+template<typename T, typename U, std::size_t OffsetBytes, std::size_t StrideBytes>
+ARRAY_VIEW_CONSTEXPR typename std::enable_if<array_view_detail::same_item_type<T, U>::value, bool>::type
+operator >= (const strided_array_iterator<T, OffsetBytes, StrideBytes> & lhs,
+            const strided_array_iterator<U, OffsetBytes, StrideBytes> & rhs) noexcept
+{
+    return lhs.get_item_base_ptr() >= rhs.get_item_base_ptr();
+}
+
+// ========================================================
+// strided_array_view bulk copy helpers:
+// ========================================================
+
+namespace array_view_detail
+{
+    //
+    // Gather/scatter between a strided channel and a contiguous array.
+    // 'items' points to the first member (OffsetBytes already applied).
+    // The SIMD versions handle as many full vectors as they can and
+    // return the number of items processed; the caller finishes the tail.
+    //
+
+    #if ARRAY_VIEW_AVX512
+    inline std::size_t simd_gather_32(const std::uint8_t * items, const std::size_t stride, const std::size_t count, std::uint8_t * dest)
+    {
+        const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        const __m512i index = _mm512_mullo_epi32(lanes, _mm512_set1_epi32(static_cast<int>(stride)));
+        std::size_t i = 0;
+        for (; i + 16 <= count; i += 16, items += stride * 16)
+        {
+            _mm512_storeu_si512(dest + i * 4, _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), 0xFFFF, index, items, 1));
+        }
+        return i;
+    }
+    inline std::size_t simd_gather_64(const std::uint8_t * items, const std::size_t stride, const std::size_t count, std::uint8_t * dest)
+    {
+        const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256i index = _mm256_mullo_epi32(lanes, _mm256_set1_epi32(static_cast<int>(stride)));
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8, items += stride * 8)
+        {
+            _mm512_storeu_si512(dest + i * 8, _mm512_mask_i32gather_epi64(_mm512_setzero_si512(), 0xFF, index, items, 1));
+        }
+        return i;
+    }
+    inline std::size_t simd_scatter_32(std::uint8_t * items, const std::size_t stride, const std::size_t count, const std::uint8_t * source)
+    {
+        const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        const __m512i index = _mm512_mullo_epi32(lanes, _mm512_set1_epi32(static_cast<int>(stride)));
+        std::size_t i = 0;
+        for (; i + 16 <= count; i += 16, items += stride * 16)
+        {
+            _mm512_i32scatter_epi32(items, index, _mm512_loadu_si512(source + i * 4), 1);
+        }
+        return i;
+    }
+    inline std::size_t simd_scatter_64(std::uint8_t * items, const std::size_t stride, const std::size_t count, const std::uint8_t * source)
+    {
+        const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256i index = _mm256_mullo_epi32(lanes, _mm256_set1_epi32(static_cast<int>(stride)));
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8, items += stride * 8)
+        {
+            _mm512_i32scatter_epi64(items, index, _mm512_loadu_si512(source + i * 8), 1);
+        }
+        return i;
+    }
+    constexpr std::size_t simd_max_lanes = 16;
+    #elif ARRAY_VIEW_AVX2
+    inline std::size_t simd_gather_32(const std::uint8_t * items, const std::size_t stride, const std::size_t count, std::uint8_t * dest)
+    {
+        const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256i index = _mm256_mullo_epi32(lanes, _mm256_set1_epi32(static_cast<int>(stride)));
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8, items += stride * 8)
+        {
+            const __m256i v = _mm256_i32gather_epi32(reinterpret_cast<const int *>(items), index, 1);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + i * 4), v);
+        }
+        return i;
+    }
+    inline std::size_t simd_gather_64(const std::uint8_t * items, const std::size_t stride, const std::size_t count, std::uint8_t * dest)
+    {
+        const __m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+        const __m128i index = _mm_mullo_epi32(lanes, _mm_set1_epi32(static_cast<int>(stride)));
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4, items += stride * 4)
+        {
+            const __m256i v = _mm256_i32gather_epi64(reinterpret_cast<const long long *>(items), index, 1);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + i * 8), v);
+        }
+        return i;
+    }
+    // AVX2 has no scatter instruction, stores stay scalar.
+    inline std::size_t simd_scatter_32(std::uint8_t *, std::size_t, std::size_t, const std::uint8_t *) { return 0; }
+    inline std::size_t simd_scatter_64(std::uint8_t *, std::size_t, std::size_t, const std::uint8_t *) { return 0; }
+    constexpr std::size_t simd_max_lanes = 8;
+    #endif // ARRAY_VIEW_AVX512 or ARRAY_VIEW_AVX2
+
+    template<typename T>
+    struct is_simd_copyable
+        : std::integral_constant<bool, std::is_trivially_copyable<T>::value && (sizeof(T) == 4 || sizeof(T) == 8)>
+    { };
+
+    template<typename T>
+    void strided_gather_scalar(const std::uint8_t * items, const std::size_t stride, const std::size_t count, T * dest)
+    {
+        for (std::size_t i = 0; i < count; ++i, items += stride)
+        {
+            dest[i] = *reinterpret_cast<const T *>(items);
+        }
+    }
+
+    template<typename T>
+    void strided_scatter_scalar(std::uint8_t * items, const std::size_t stride, const std::size_t count, const T * source)
+    {
+        for (std::size_t i = 0; i < count; ++i, items += stride)
+        {
+            *reinterpret_cast<T *>(items) = source[i];
+        }
+    }
+
+    template<typename T>
+    void strided_gather(const std::uint8_t * items, const std::size_t stride, const std::size_t count, T * dest, std::false_type)
+    {
+        strided_gather_scalar(items, stride, count, dest);
+    }
+
+    template<typename T>
+    void strided_gather(const std::uint8_t * items, const std::size_t stride, const std::size_t count, T * dest, std::true_type)
+    {
+        if (stride == sizeof(T))
+        {
+            std::memcpy(dest, items, count * sizeof(T));
+            return;
+        }
+
+        std::size_t done = 0;
+        #if ARRAY_VIEW_AVX512 || ARRAY_VIEW_AVX2
+        // Gather indexes are signed 32-bit byte offsets from the base.
+        if (stride * simd_max_lanes <= 0x7FFFFFFF)
+        {
+            std::uint8_t * dest_bytes = reinterpret_cast<std::uint8_t *>(dest);
+            done = (sizeof(T) == 4) ? simd_gather_32(items, stride, count, dest_bytes)
+                                    : simd_gather_64(items, stride, count, dest_bytes);
+        }
+        #endif // ARRAY_VIEW_AVX512 || ARRAY_VIEW_AVX2
+        strided_gather_scalar(items + done * stride, stride, count - done, dest + done);
+    }
+
+    template<typename T>
+    void strided_scatter(std::uint8_t * items, const std::size_t stride, const std::size_t count, const T * source, std::false_type)
+    {
+        strided_scatter_scalar(items, stride, count, source);
+    }
+
+    template<typename T>
+    void strided_scatter(std::uint8_t * items, const std::size_t stride, const std::size_t count, const T * source, std::true_type)
+    {
+        if (stride == sizeof(T))
+        {
+            std::memcpy(items, source, count * sizeof(T));
+            return;
+        }
+
+        std::size_t done = 0;
+        #if ARRAY_VIEW_AVX512 || ARRAY_VIEW_AVX2
+        if (stride * simd_max_lanes <= 0x7FFFFFFF)
+        {
+            const std::uint8_t * source_bytes = reinterpret_cast<const std::uint8_t *>(source);
+            done = (sizeof(T) == 4) ? simd_scatter_32(items, stride, count, source_bytes)
+                                    : simd_scatter_64(items, stride, count, source_bytes);
+        }
+        #endif // ARRAY_VIEW_AVX512 || ARRAY_VIEW_AVX2
+        strided_scatter_scalar(items + done * stride, stride, count - done, source + done);
+    }
+} // namespace array_view_detail {}
+
+// ========================================================
+// template class strided_array_view:
+// ========================================================
+
+//
+// Experimental strided_array_view.
+// Allows accessing members of structured types as
+// if it was an array_view of the member type itself.
+//
+// OffsetBytes and StrideBytes can both be dynamic_extent,
+// in which case they are supplied to the constructor instead.
+// See the dynamic_strided_array_view alias below.
+//
+// Items are accessed through T pointers, so they must be aligned
+// for T. For packed records with misaligned or byte-swapped fields
+// use packed_field_view, from array_view_endian.hpp.
+//
+// See the example code below for a reference.
+//
+template
+<
+    typename T,
+    std::size_t OffsetBytes,
+    std::size_t StrideBytes
+>
+class strided_array_view final
+    : private array_view_detail::stride_storage<OffsetBytes, StrideBytes>
+{
+    using stride_storage_type = array_view_detail::stride_storage<OffsetBytes, StrideBytes>;
+
+    static_assert((OffsetBytes == dynamic_extent) == (StrideBytes == dynamic_extent),
+                  "OffsetBytes and StrideBytes must be either both static or both dynamic_extent!");
+    static_assert(StrideBytes == dynamic_extent || (StrideBytes != 0 && OffsetBytes + sizeof(T) <= StrideBytes),
+                  "strided_array_view item doesn't fit in the stride!");
+
+public:
+
+    //
+    // Nested types:
+    //
+
+    using value_type      = T;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using pointer         = typename std::add_pointer<value_type>::type;
+    using reference       = typename std::add_lvalue_reference<value_type>::type;
+    using const_pointer   = typename std::add_pointer<const value_type>::type;
+    using const_reference = typename std::add_lvalue_reference<const value_type>::type;
+
+    using byte_type       = typename std::conditional<std::is_const<value_type>::value, const std::uint8_t, std::uint8_t>::type;
+    using byte_ptr_type   = typename std::add_pointer<byte_type>::type;
+
+    using iterator               = strided_array_iterator<value_type, OffsetBytes, StrideBytes>;
+    using const_iterator         = strided_array_iterator<const value_type, OffsetBytes, StrideBytes>;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // True if the compile-time layout has no gaps between items (StrideBytes
+    // == sizeof(T), so OffsetBytes is 0), which makes this an array_view in
+    // disguise. See also is_contiguous_view and as_array_view().
+    static constexpr bool is_contiguous = (StrideBytes == sizeof(T));
+
+    //
+    // Constructors / assignment:
+    //
+
+    // Default stride of a runtime layout is sizeof(T), so that
+    // an empty view still has a valid layout.
+    ARRAY_VIEW_CONSTEXPR strided_array_view() noexcept
+        : stride_storage_type{ 0, sizeof(value_type) }
+        , m_pointer{ nullptr }
+        , m_size_in_items{ 0 }
+    { }
+
+    // Compile-time layout.
+    template
+    <
+        typename StructuredType,
+        size_type S = StrideBytes,
+        typename std::enable_if<S != dynamic_extent, int>::type = 0
+    >
+    strided_array_view(StructuredType * array_ptr, const size_type size_in_items) noexcept
+        : m_pointer{ reinterpret_cast<byte_ptr_type>(array_ptr) }
+        , m_size_in_items{ (size_in_items * sizeof(StructuredType)) / StrideBytes }
+    {
+        ARRAY_VIEW_INSTRUMENT_CREATED(strided_view, m_size_in_items);
+    }
+
+    // Runtime layout. StructuredType can be a byte type if the
+    // structure is not known, in which case size_in_items is in bytes.
+    template
+    <
+        typename StructuredType,
+        size_type S = StrideBytes,
+        typename std::enable_if<S == dynamic_extent, int>::type = 0
+    >
+    strided_array_view(StructuredType * array_ptr, const size_type size_in_items,
+                       const size_type offset_in_bytes, const size_type stride_in_bytes) ARRAY_VIEW_UNCHECKED_NOEXCEPT
+        : stride_storage_type{ offset_in_bytes, stride_in_bytes }
+        , m_pointer{ reinterpret_cast<byte_ptr_type>(array_ptr) }
+        , m_size_in_items{ (stride_in_bytes != 0) ? (size_in_items * sizeof(StructuredType)) / stride_in_bytes : 0 }
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (stride_in_bytes == 0)
+        {
+            ARRAY_VIEW_ERROR("strided_array_view stride is zero!");
+        }
+        if (offset_in_bytes + sizeof(value_type) > stride_in_bytes)
+        {
+            ARRAY_VIEW_ERROR("strided_array_view item doesn't fit in the stride!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+        ARRAY_VIEW_INSTRUMENT_CREATED(strided_view, m_size_in_items);
+    }
+
+    strided_array_view(const strided_array_view & other) = default;
+    strided_array_view & operator = (const strided_array_view & other) = default;
+
+    // Any strided view converts to the runtime layout form, and
+    // views of U convert to views of const U with the same layout.
+    template
+    <
+        typename ConvertibleType,
+        std::size_t OtherOffsetBytes,
+        std::size_t OtherStrideBytes,
+        typename std::enable_if<std::is_convertible<ConvertibleType *, value_type *>::value &&
+                                (StrideBytes == dynamic_extent ||
+                                 (OffsetBytes == OtherOffsetBytes && StrideBytes == OtherStrideBytes)), int>::type = 0
+    >
+    ARRAY_VIEW_CONSTEXPR strided_array_view(const strided_array_view<ConvertibleType, OtherOffsetBytes, OtherStrideBytes> & other) noexcept
+        : stride_storage_type{ other.offset_bytes(), other.stride_bytes() }
+        , m_pointer{ other.data() }
+        , m_size_in_items{ other.size() }
+    { }
+
+    //
+    // Miscellaneous queries:
+    //
+
+    ARRAY_VIEW_CONSTEXPR byte_ptr_type data() const noexcept
+    {
+        return m_pointer;
+    }
+    ARRAY_VIEW_CONSTEXPR byte_ptr_type data() noexcept
+    {
+        return m_pointer;
+    }
+    ARRAY_VIEW_CONSTEXPR bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+    // Bytes spanned by the size() whole structures. A trailing
+    // partial structure passed to the constructor isn't counted.
+    ARRAY_VIEW_CONSTEXPR size_type size_bytes() const noexcept
+    {
+        return size() * stride_bytes();
+    }
+    // The item count is computed once by the constructors, so this
+    // is a plain load, even for strides that aren't a power of two.
+    ARRAY_VIEW_CONSTEXPR size_type size() const noexcept
+    {
+        return m_size_in_items;
+    }
+
+    // Static constexpr for compile-time layouts, plain members otherwise.
+    using stride_storage_type::offset_bytes;
+    using stride_storage_type::stride_bytes;
+
+    // Runtime counterpart of is_contiguous, also true for a
+    // dynamic layout that happens to have stride == sizeof(T).
+    ARRAY_VIEW_CONSTEXPR bool contiguous() const noexcept
+    {
+        return stride_bytes() == sizeof(value_type);
+    }
+
+    //
+    // Contiguous layouts as array_views, to use the memcpy/SIMD paths
+    // of array_view. Only available for compile-time layouts that are
+    // contiguous; dynamic layouts must be, checked by ARRAY_VIEW_DEBUG_CHECKS.
+    //
+
+    template<size_type S = StrideBytes, typename std::enable_if<S == dynamic_extent || S == sizeof(T), int>::type = 0>
+    array_view<const value_type> as_array_view() const ARRAY_VIEW_UNCHECKED_NOEXCEPT
+    {
+        check_contiguous();
+        return array_view<const value_type>{ reinterpret_cast<const_pointer>(m_pointer), size() };
+    }
+    template<size_type S = StrideBytes, typename std::enable_if<S == dynamic_extent || S == sizeof(T), int>::type = 0>
+    array_view<value_type> as_array_view() ARRAY_VIEW_UNCHECKED_NOEXCEPT
+    {
+        check_contiguous();
+        return array_view<value_type>{ reinterpret_cast<pointer>(m_pointer), size() };
+    }
+
+    //
+    // Compare against nullptr (test for a null strided_array_view):
+    //
+
+    ARRAY_VIEW_CONSTEXPR bool operator == (std::nullptr_t) const noexcept
+    {
+        return data() == nullptr;
+    }
+    ARRAY_VIEW_CONSTEXPR bool operator != (std::nullptr_t) const noexcept
+    {
+        return !(*this == nullptr);
+    }
+
+    //
     // Data access:
     //
 
     const_reference at(const size_type index) const
     {
-        // at() always validates the array_view and index.
-        // operator[] uses debug checks that can be disabled if
-        // you care more about performance than runtime checking.
-        check_not_null();
+        // at() always validates the bounds.
+        ARRAY_VIEW_INSTRUMENT_ACCESS(strided_view, index, size());
+        if (data() == nullptr)
+        {
+            ARRAY_VIEW_ERROR("strided_array_view: null pointer!");
+        }
         if (index >= size())
         {
-            ARRAY_VIEW_ERROR("array_view::at(): index is out-of-bounds!");
+            ARRAY_VIEW_ERROR("strided_array_view::at(): index is out-of-bounds!");
         }
-        return *(data() + index);
+
+        return *reinterpret_cast<const_pointer>(get_item_raw_ptr(index));
     }
     reference at(const size_type index)
     {
         // Always checked.
-        check_not_null();
+        ARRAY_VIEW_INSTRUMENT_ACCESS(strided_view, index, size());
+        if (data() == nullptr)
+        {
+            ARRAY_VIEW_ERROR("strided_array_view: null pointer!");
+        }
         if (index >= size())
         {
-            ARRAY_VIEW_ERROR("array_view::at(): index is out-of-bounds!");
+            ARRAY_VIEW_ERROR("strided_array_view::at(): index is out-of-bounds!");
         }
-        return *(data() + index);
+
+        return *reinterpret_cast<pointer>(get_item_raw_ptr(index));
     }
 
     const_reference operator[](const size_type index) const
     {
-        // Unlike with at() these checks can be disabled for better performance.
+        ARRAY_VIEW_INSTRUMENT_ACCESS(strided_view, index, size());
         #if ARRAY_VIEW_DEBUG_CHECKS
-        check_not_null();
+        if (data() == nullptr)
+        {
+            ARRAY_VIEW_ERROR("strided_array_view: null pointer!");
+        }
         if (index >= size())
         {
-            ARRAY_VIEW_ERROR("array_view::operator[]: index is out-of-bounds!");
+            ARRAY_VIEW_ERROR("strided_array_view::operator[]: index is out-of-bounds!");
         }
         #endif // ARRAY_VIEW_DEBUG_CHECKS
 
-        return *(data() + index);
+        return *reinterpret_cast<const_pointer>(get_item_raw_ptr(index));
     }
     reference operator[](const size_type index)
     {
+        ARRAY_VIEW_INSTRUMENT_ACCESS(strided_view, index, size());
         #if ARRAY_VIEW_DEBUG_CHECKS
-        check_not_null();
+        if (data() == nullptr)
+        {
+            ARRAY_VIEW_ERROR("strided_array_view: null pointer!");
+        }
         if (index >= size())
         {
-            ARRAY_VIEW_ERROR("array_view::operator[]: index is out-of-bounds!");
+            ARRAY_VIEW_ERROR("strided_array_view::operator[]: index is out-of-bounds!");
         }
         #endif // ARRAY_VIEW_DEBUG_CHECKS
 
-        return *(data() + index);
+        return *reinterpret_cast<pointer>(get_item_raw_ptr(index));
+    }
+
+    // These are never checked. Use at your own risk.
+    ARRAY_VIEW_CONSTEXPR byte_ptr_type get_item_raw_ptr(const size_type index) noexcept
+    {
+        return m_pointer + (index * stride_bytes()) + offset_bytes();
+    }
+    ARRAY_VIEW_CONSTEXPR byte_ptr_type get_item_raw_ptr(const size_type index) const noexcept
+    {
+        return m_pointer + (index * stride_bytes()) + offset_bytes();
     }
 
     //
-    // Begin/end range iterators, front()/back():
+    // Bulk copies between the strided channel and contiguous memory
+    // (AoS to SoA and back). 4 and 8 byte trivially copyable types use
+    // AVX2/AVX-512 gathers (and AVX-512 scatters) when available,
+    // everything else is a scalar loop.
+    //
+
+    // Copies all size() items into dest, which must be at least as big.
+    void gather_to(array_view<typename std::remove_const<value_type>::type> dest) const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (dest.size() < size())
+        {
+            ARRAY_VIEW_ERROR("strided_array_view::gather_to(): destination is too small!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        if (empty())
+        {
+            return;
+        }
+        using item_type = typename std::remove_const<value_type>::type;
+        array_view_detail::strided_gather(get_item_raw_ptr(0), stride_bytes(), size(), dest.data(),
+                                          array_view_detail::is_simd_copyable<item_type>{});
+    }
+
+    // Overwrites the first source.size() items of the channel.
+    void scatter_from(array_view<const typename std::remove_const<value_type>::type> source)
+    {
+        static_assert(!std::is_const<value_type>::value, "Can't scatter into a strided_array_view of const!");
+
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (source.size() > size())
+        {
+            ARRAY_VIEW_ERROR("strided_array_view::scatter_from(): source is bigger than the view!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        if (source.empty())
+        {
+            return;
+        }
+        using item_type = typename std::remove_const<value_type>::type;
+        array_view_detail::strided_scatter(get_item_raw_ptr(0), stride_bytes(), source.size(), source.data(),
+                                           array_view_detail::is_simd_copyable<item_type>{});
+    }
+
+    reference front()
+    {
+        return operator[](0);
+    }
+    const_reference front() const
+    {
+        return operator[](0);
+    }
+
+    reference back()
+    {
+        return operator[](size() - 1);
+    }
+    const_reference back() const
+    {
+        return operator[](size() - 1);
+    }
+
+    //
+    // Begin/end range iterators:
     //
 
     // forward begin:
-    iterator begin() noexcept
+    ARRAY_VIEW_CONSTEXPR iterator begin() noexcept
     {
-        return make_iterator(0);
+        return iterator{ m_pointer, layout() };
     }
-    const_iterator begin() const noexcept
+    ARRAY_VIEW_CONSTEXPR const_iterator begin() const noexcept
     {
-        return make_const_iterator(0);
+        return const_iterator{ m_pointer, layout() };
     }
-    const_iterator cbegin() const noexcept
+    ARRAY_VIEW_CONSTEXPR const_iterator cbegin() const noexcept
     {
-        return make_const_iterator(0);
+        return const_iterator{ m_pointer, layout() };
     }
 
     // forward end:
-    iterator end() noexcept
+    ARRAY_VIEW_CONSTEXPR iterator end() noexcept
     {
-        return make_iterator(size());
+        return iterator{ end_item_ptr(), layout() };
     }
-    const_iterator end() const noexcept
+    ARRAY_VIEW_CONSTEXPR const_iterator end() const noexcept
     {
-        return make_const_iterator(size());
+        return const_iterator{ end_item_ptr(), layout() };
     }
-    const_iterator cend() const noexcept
+    ARRAY_VIEW_CONSTEXPR const_iterator cend() const noexcept
     {
-        return make_const_iterator(size());
+        return const_iterator{ end_item_ptr(), layout() };
     }
 
     // reverse begin:
@@ -593,195 +3861,626 @@ public:
         return const_reverse_iterator{ cbegin() };
     }
 
-    reference front()
+    //
+    // Non-throwing swap() overload for strided_array_view:
+    //
+
+    friend void swap(strided_array_view & lhs, strided_array_view & rhs) noexcept
     {
-        #if ARRAY_VIEW_DEBUG_CHECKS
-        check_not_null();
-        #endif // ARRAY_VIEW_DEBUG_CHECKS
-        return *data();
+        using std::swap;
+        swap(lhs.m_pointer, rhs.m_pointer);
+        swap(lhs.m_size_in_items, rhs.m_size_in_items);
+        swap(static_cast<stride_storage_type &>(lhs), static_cast<stride_storage_type &>(rhs));
     }
-    const_reference front() const
+
+private:
+
+    constexpr const stride_storage_type & layout() const noexcept
     {
-        #if ARRAY_VIEW_DEBUG_CHECKS
-        check_not_null();
-        #endif // ARRAY_VIEW_DEBUG_CHECKS
-        return *data();
+        return *this;
     }
 
-    reference back()
+    void check_contiguous() const ARRAY_VIEW_UNCHECKED_NOEXCEPT
     {
         #if ARRAY_VIEW_DEBUG_CHECKS
-        check_not_null();
+        if (!contiguous())
+        {
+            ARRAY_VIEW_ERROR("strided_array_view::as_array_view(): layout isn't contiguous!");
+        }
         #endif // ARRAY_VIEW_DEBUG_CHECKS
-        return *(data() + size() - 1);
     }
-    const_reference back() const
+
+    // One past the last whole structure in the view.
+    ARRAY_VIEW_CONSTEXPR byte_ptr_type end_item_ptr() const noexcept
     {
-        #if ARRAY_VIEW_DEBUG_CHECKS
-        check_not_null();
-        #endif // ARRAY_VIEW_DEBUG_CHECKS
-        return *(data() + size() - 1);
+        return m_pointer + (size() * stride_bytes());
     }
 
-    //
-    // Miscellaneous queries:
-    //
+    byte_ptr_type m_pointer;
+    size_type m_size_in_items;
+};
+
+//
+// strided_array_view with the offset and stride given at runtime,
+// for layouts only known at load time (asset files, shader reflection, etc).
+// A single non-template function taking a dynamic_strided_array_view<T>
+// can then handle any layout; compile-time views convert to it implicitly.
+//
+template<typename T>
+using dynamic_strided_array_view = strided_array_view<T, dynamic_extent, dynamic_extent>;
+
+template<typename T, std::size_t OffsetBytes, std::size_t StrideBytes>
+constexpr bool strided_array_view<T, OffsetBytes, StrideBytes>::is_contiguous;
+
+//
+// True for view types whose items are adjacent by construction: any
+// array_view, and strided_array_views with is_contiguous layouts.
+// Generic code taking either kind of view can dispatch on it to the
+// contiguous paths, with as_array_view() for the strided ones.
+//
+template<typename View>
+struct is_contiguous_view : std::false_type { };
+
+template<typename T, std::size_t Extent>
+struct is_contiguous_view<array_view<T, Extent>> : std::true_type { };
+
+template<typename T, std::size_t OffsetBytes, std::size_t StrideBytes>
+struct is_contiguous_view<strided_array_view<T, OffsetBytes, StrideBytes>>
+    : std::integral_constant<bool, strided_array_view<T, OffsetBytes, StrideBytes>::is_contiguous> { };
+
+// ========================================================
+// make_strided_array_view() helpers:
+// ========================================================
+
+//
+// Strided views over byte buffers, for records whose layout is only
+// known as byte offsets, like interleaved vertex streams or fixed-size
+// wire records. The byte view covers size() * stride bytes (a trailing
+// partial record is ignored). T must be const if the bytes are.
+// ARRAY_VIEW_DEBUG_CHECKS validate that every item is aligned for T.
+//
+//  auto normals = make_strided_array_view<const Vec3>(bytes, offsetof(Vertex, normal), sizeof(Vertex));
+//
+template<typename T, typename ByteType, std::size_t Extent>
+dynamic_strided_array_view<T> make_strided_array_view(array_view<ByteType, Extent> bytes,
+                                                      const std::size_t offset_in_bytes,
+                                                      const std::size_t stride_in_bytes) ARRAY_VIEW_UNCHECKED_NOEXCEPT
+{
+    static_assert(sizeof(ByteType) == 1, "make_strided_array_view() needs a view of bytes!");
+    static_assert(std::is_const<T>::value || !std::is_const<ByteType>::value,
+                  "make_strided_array_view() can't cast away const!");
 
-    bool empty() const noexcept
+    #if ARRAY_VIEW_DEBUG_CHECKS
+    array_view_detail::check_cast_alignment(bytes.data() + offset_in_bytes, alignof(T),
+                                            "make_strided_array_view(): first item is misaligned!");
+    if (stride_in_bytes % alignof(T) != 0)
     {
-        return size() == 0;
+        ARRAY_VIEW_ERROR("make_strided_array_view(): stride misaligns the items!");
     }
-    size_type size() const noexcept
+    #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+    return dynamic_strided_array_view<T>{ bytes.data(), bytes.size(), offset_in_bytes, stride_in_bytes };
+}
+
+// Same with the layout fixed at compile-time.
+template<typename T, std::size_t OffsetBytes, std::size_t StrideBytes, typename ByteType, std::size_t Extent>
+strided_array_view<T, OffsetBytes, StrideBytes> make_strided_array_view(array_view<ByteType, Extent> bytes) ARRAY_VIEW_UNCHECKED_NOEXCEPT
+{
+    static_assert(sizeof(ByteType) == 1, "make_strided_array_view() needs a view of bytes!");
+    static_assert(std::is_const<T>::value || !std::is_const<ByteType>::value,
+                  "make_strided_array_view() can't cast away const!");
+    static_assert(OffsetBytes + sizeof(T) <= StrideBytes, "strided_array_view item doesn't fit in the stride!");
+    static_assert(StrideBytes % alignof(T) == 0, "make_strided_array_view(): stride misaligns the items!");
+
+    #if ARRAY_VIEW_DEBUG_CHECKS
+    array_view_detail::check_cast_alignment(bytes.data() + OffsetBytes, alignof(T),
+                                            "make_strided_array_view(): first item is misaligned!");
+    #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+    return strided_array_view<T, OffsetBytes, StrideBytes>{ bytes.data(), bytes.size() };
+}
+
+// ========================================================
+// class array_view_write_guard:
+// ========================================================
+
+//
+// With ARRAY_VIEW_RACE_CHECKS defined to nonzero, an array_view_write_guard
+// declares that the current thread is about to write through a view. While
+// it is alive, the view's bytes are registered in a process-wide table, and
+// a guard taken by another thread over any of the same bytes is reported
+// with ARRAY_VIEW_ERROR. Wrap the work each thread does on its slice of a
+// shared buffer in one to catch overlapping partitions as they happen:
+//
+//  pool.run(parts.size(), [&](const std::size_t part) {
+//      const array_view_write_guard guard{ parts[part] };
+//      ...write parts[part]...
+//  });
+//
+// parallel_for() in array_view_algorithms.hpp already does this per task.
+// Guards on the same thread may overlap, so nested work is fine. Views of
+// const are accepted and not registered. Strided views register only the
+// item bytes: two threads writing different members of the same structures
+// don't conflict. Overlap between strided views of different strides is
+// approximated by their byte spans, so it may report false positives.
+//
+// The table is a fixed array of ARRAY_VIEW_RACE_CHECK_SLOTS slots, claimed
+// with a CAS and published under a per-slot sequence counter, so taking a
+// guard never locks. Each guard scans the slots in use, which is fine for
+// test and canary builds. Running out of slots is reported as an error.
+// When the switch is off the guard is an empty class and costs nothing.
+//
+#if ARRAY_VIEW_RACE_CHECKS
+
+#ifndef ARRAY_VIEW_NO_STD_INCLUDES
+    #include <atomic>
+#endif // ARRAY_VIEW_NO_STD_INCLUDES
+
+#ifndef ARRAY_VIEW_RACE_CHECK_SLOTS
+    #define ARRAY_VIEW_RACE_CHECK_SLOTS 256
+#endif // ARRAY_VIEW_RACE_CHECK_SLOTS
+
+namespace array_view_detail
+{
+    // count items of item_bytes each, stride bytes apart.
+    struct race_range
     {
-        return m_size_in_items;
-    }
-    size_type size_bytes() const noexcept
+        std::uintptr_t first;
+        std::size_t    stride;
+        std::size_t    item_bytes;
+        std::size_t    count;
+
+        std::uintptr_t end() const noexcept
+        {
+            return first + (count - 1) * stride + item_bytes;
+        }
+    };
+
+    // True if an item of r intersects [begin, end).
+    inline bool race_range_hits(const race_range & r, const std::uintptr_t begin, const std::uintptr_t end) noexcept
     {
-        return m_size_in_items * sizeof(value_type);
+        // First item ending past begin.
+        std::size_t k = 0;
+        if (begin >= r.first + r.item_bytes)
+        {
+            k = (begin - r.first - r.item_bytes) / r.stride + 1;
+        }
+        return k < r.count && r.first + k * r.stride < end;
     }
-    const_pointer data() const noexcept
+
+    inline bool race_ranges_overlap(const race_range & a, const race_range & b) noexcept
     {
-        return m_pointer;
+        if (a.end() <= b.first || b.end() <= a.first)
+        {
+            return false;
+        }
+        if (a.stride == a.item_bytes)
+        {
+            return race_range_hits(b, a.first, a.end());
+        }
+        if (b.stride == b.item_bytes)
+        {
+            return race_range_hits(a, b.first, b.end());
+        }
+        if (a.stride == b.stride)
+        {
+            // Same structure size: compare where the items sit in it.
+            const std::size_t stride = a.stride;
+            const std::size_t delta  = static_cast<std::size_t>((b.first % stride) + stride - (a.first % stride)) % stride;
+            return delta < a.item_bytes || stride - delta < b.item_bytes;
+        }
+        return true;
     }
-    pointer data() noexcept
+
+    struct race_slot
     {
-        return m_pointer;
+        std::atomic<std::uintptr_t> owner;    // Thread token, 0 if the slot is free.
+        std::atomic<std::uint32_t>  sequence; // Odd while the range is being written.
+        std::atomic<std::uintptr_t> first;
+        std::atomic<std::size_t>    stride;
+        std::atomic<std::size_t>    item_bytes;
+        std::atomic<std::size_t>    count;    // 0 when no range is published.
+    };
+
+    struct race_registry
+    {
+        race_slot slots[ARRAY_VIEW_RACE_CHECK_SLOTS];
+        std::atomic<std::size_t> slots_used; // High-water mark, bounds the scans.
+
+        static race_registry & instance() noexcept
+        {
+            // Zero-initialized as a static, before any guard can run.
+            static race_registry registry;
+            return registry;
+        }
+    };
+
+    // Distinct for every live thread.
+    inline std::uintptr_t race_thread_token() noexcept
+    {
+        static thread_local char token;
+        return reinterpret_cast<std::uintptr_t>(&token);
     }
 
-    //
-    // Compare against nullptr (test for a null array_view):
-    //
+    inline void race_publish(race_slot & slot, const race_range & range) noexcept
+    {
+        slot.sequence.fetch_add(1);
+        slot.first.store(range.first);
+        slot.stride.store(range.stride);
+        slot.item_bytes.store(range.item_bytes);
+        slot.count.store(range.count);
+        slot.sequence.fetch_add(1);
+    }
 
-    bool operator == (std::nullptr_t) const noexcept
+    inline void race_release(race_slot & slot) noexcept
     {
-        return data() == nullptr;
+        slot.sequence.fetch_add(1);
+        slot.count.store(0);
+        slot.sequence.fetch_add(1);
+        slot.owner.store(0);
     }
-    bool operator != (std::nullptr_t) const noexcept
+
+    // Reads a consistent copy of the slot's range, waiting out a writer.
+    inline race_range race_read(const race_slot & slot) noexcept
     {
-        return !(*this == nullptr);
+        race_range range;
+        for (;;)
+        {
+            const std::uint32_t before = slot.sequence.load();
+            if ((before & 1) != 0)
+            {
+                continue;
+            }
+            range.first      = slot.first.load();
+            range.stride     = slot.stride.load();
+            range.item_bytes = slot.item_bytes.load();
+            range.count      = slot.count.load();
+            if (slot.sequence.load() == before)
+            {
+                return range;
+            }
+        }
     }
 
     //
-    // Compare for same array pointer and size:
+    // Claims a slot, publishes the range, then checks it against every
+    // other thread's. All operations are sequentially consistent, so of two
+    // threads acquiring overlapping ranges at the same time at least one
+    // sees the other's published range. Returns the slot index, or -1 for
+    // an empty range.
     //
-
-    bool operator == (const array_view & other) const noexcept
+    inline int race_acquire(race_range range)
     {
-        // Pointers to same memory (or both null).
-        if (data() == other.data())
+        if (range.count == 0 || range.item_bytes == 0)
+        {
+            return -1;
+        }
+        if (range.count == 1)
+        {
+            range.stride = range.item_bytes;
+        }
+
+        race_registry & registry = race_registry::instance();
+        const std::uintptr_t token = race_thread_token();
+
+        int index = -1;
+        for (int i = 0; i < ARRAY_VIEW_RACE_CHECK_SLOTS; ++i)
+        {
+            std::uintptr_t expected = 0;
+            if (registry.slots[i].owner.compare_exchange_strong(expected, token))
+            {
+                index = i;
+                break;
+            }
+        }
+        if (index < 0)
+        {
+            ARRAY_VIEW_ERROR("array_view_write_guard: out of slots, increase ARRAY_VIEW_RACE_CHECK_SLOTS!");
+            return -1;
+        }
+
+        std::size_t used = registry.slots_used.load();
+        while (used <= static_cast<std::size_t>(index) &&
+               !registry.slots_used.compare_exchange_weak(used, static_cast<std::size_t>(index) + 1))
+        {
+        }
+
+        race_slot & mine = registry.slots[index];
+        race_publish(mine, range);
+
+        const std::size_t scan_count = registry.slots_used.load();
+        for (std::size_t i = 0; i < scan_count; ++i)
         {
-            return true;
+            const race_slot & other = registry.slots[i];
+            const std::uintptr_t other_owner = other.owner.load();
+            if (i == static_cast<std::size_t>(index) || other_owner == 0 || other_owner == token)
+            {
+                continue;
+            }
+            const race_range other_range = race_read(other);
+            if (other_range.count != 0 && race_ranges_overlap(range, other_range))
+            {
+                race_release(mine);
+                ARRAY_VIEW_ERROR("array_view_write_guard: another thread is writing to an overlapping range!");
+                return -1;
+            }
         }
+        return index;
+    }
+} // namespace array_view_detail {}
+
+#endif // ARRAY_VIEW_RACE_CHECKS
+
+class array_view_write_guard final
+{
+public:
 
-        // Different sizes, whole sequence can't be identical.
-        if (size() != other.size())
+    array_view_write_guard() noexcept = default;
+
+    template<typename T, std::size_t Extent>
+    explicit array_view_write_guard(const array_view<T, Extent> & view)
+    {
+        #if ARRAY_VIEW_RACE_CHECKS
+        if (!std::is_const<T>::value)
         {
-            return false;
+            m_slot = array_view_detail::race_acquire(array_view_detail::race_range{
+                reinterpret_cast<std::uintptr_t>(view.data()), sizeof(T), sizeof(T), view.size() });
         }
-
-        // Compare each element:
-        return std::equal(begin(), end(), other.begin());
+        #else // !ARRAY_VIEW_RACE_CHECKS
+        (void)view;
+        #endif // ARRAY_VIEW_RACE_CHECKS
     }
-    bool operator != (const array_view & other) const noexcept
+
+    template<typename T, std::size_t OffsetBytes, std::size_t StrideBytes>
+    explicit array_view_write_guard(const strided_array_view<T, OffsetBytes, StrideBytes> & view)
     {
-        return !(*this == other);
+        #if ARRAY_VIEW_RACE_CHECKS
+        if (!std::is_const<T>::value && !view.empty())
+        {
+            m_slot = array_view_detail::race_acquire(array_view_detail::race_range{
+                reinterpret_cast<std::uintptr_t>(view.get_item_raw_ptr(0)), view.stride_bytes(), sizeof(T), view.size() });
+        }
+        #else // !ARRAY_VIEW_RACE_CHECKS
+        (void)view;
+        #endif // ARRAY_VIEW_RACE_CHECKS
     }
 
-    //
-    // Compare pointer value for ordering (useful for containers/sorting):
-    //
+    array_view_write_guard(const array_view_write_guard &) = delete;
+    array_view_write_guard & operator = (const array_view_write_guard &) = delete;
 
-    bool operator < (const array_view & other) const noexcept
-    {
-        return data() < other.data();
-    }
-    bool operator > (const array_view & other) const noexcept
+    #if ARRAY_VIEW_RACE_CHECKS
+    array_view_write_guard(array_view_write_guard && other) noexcept
+        : m_slot{ other.m_slot }
     {
-        return data() > other.data();
+        other.m_slot = -1;
     }
-    bool operator <= (const array_view & other) const noexcept
+    array_view_write_guard & operator = (array_view_write_guard && other) noexcept
     {
-        return !(*this > other);
+        if (this != &other)
+        {
+            release();
+            m_slot = other.m_slot;
+            other.m_slot = -1;
+        }
+        return *this;
     }
-    bool operator >= (const array_view & other) const noexcept
+    ~array_view_write_guard()
     {
-        return !(*this < other);
+        release();
     }
 
-    //
-    // Non-throwing swap() overload for array_views:
-    //
-
-    friend void swap(array_view & lhs, array_view & rhs) noexcept
+    // Unregisters the range before the guard goes out of scope.
+    void release() noexcept
     {
-        using std::swap;
-        swap(lhs.m_pointer, rhs.m_pointer);
-        swap(lhs.m_size_in_items, rhs.m_size_in_items);
+        if (m_slot >= 0)
+        {
+            array_view_detail::race_release(array_view_detail::race_registry::instance().slots[m_slot]);
+            m_slot = -1;
+        }
     }
+    #else // !ARRAY_VIEW_RACE_CHECKS
+    array_view_write_guard(array_view_write_guard &&) noexcept = default;
+    array_view_write_guard & operator = (array_view_write_guard &&) noexcept = default;
+    void release() noexcept { }
+    #endif // ARRAY_VIEW_RACE_CHECKS
 
 private:
 
-    void check_not_null() const
+    #if ARRAY_VIEW_RACE_CHECKS
+    int m_slot = -1;
+    #endif // ARRAY_VIEW_RACE_CHECKS
+};
+
+// ========================================================
+// for_each_prefetched():
+// ========================================================
+
+namespace array_view_detail
+{
+    // Visits count items starting at first_item, stride_bytes apart, calling
+    // visit(item_ptr). Issues one prefetch per cache line touched, for the
+    // item distance_items ahead, so small items don't prefetch the same
+    // line repeatedly and items of a cache line or more get one each.
+    template<typename ItemType, typename ByteType, typename VisitFunc>
+    void prefetched_scan(ByteType * first_item, const std::size_t stride_bytes, const std::size_t count,
+                         std::size_t distance_items, VisitFunc & visit)
     {
-        if (data() == nullptr || empty())
+        if (distance_items == 0)
         {
-            ARRAY_VIEW_ERROR("array_view pointer is null or size is zero!");
+            distance_items = (ARRAY_VIEW_PREFETCH_DISTANCE_BYTES + stride_bytes - 1) / stride_bytes;
         }
-    }
 
-    iterator make_iterator(const difference_type start_offset) noexcept
-    {
-        return (data() != nullptr) ? iterator{ this, start_offset } : iterator{};
-    }
+        const std::size_t items_per_line = (stride_bytes < ARRAY_VIEW_CACHE_LINE_SIZE)
+                                         ? (ARRAY_VIEW_CACHE_LINE_SIZE / stride_bytes) : 1;
 
-    const_iterator make_const_iterator(const difference_type start_offset) const noexcept
-    {
-        return (data() != nullptr) ? const_iterator{ this, start_offset } : const_iterator{};
-    }
+        // Main loop, while the prefetched items are inside the view.
+        std::size_t i = 0;
+        for (; i + distance_items + items_per_line <= count; i += items_per_line)
+        {
+            ARRAY_VIEW_PREFETCH(first_item + (i + distance_items) * stride_bytes);
+            for (std::size_t j = 0; j < items_per_line; ++j)
+            {
+                visit(*reinterpret_cast<ItemType *>(first_item + (i + j) * stride_bytes));
+            }
+        }
 
-    // Pointer is just a reference to external memory. Not owned by array_view.
-    pointer   m_pointer;
-    size_type m_size_in_items;
-};
+        // Tail, already prefetched.
+        for (; i < count; ++i)
+        {
+            visit(*reinterpret_cast<ItemType *>(first_item + i * stride_bytes));
+        }
+    }
+} // namespace array_view_detail {}
 
 //
-// make_array_view() helpers:
+// Same as std::for_each(view.begin(), view.end(), func), but issuing
+// software prefetches distance_items ahead of the current item. Helps
+// scans over views much bigger than L2, and strided views with large
+// strides in particular, where the hardware prefetcher falls behind.
+// A zero distance uses ARRAY_VIEW_PREFETCH_DISTANCE_BYTES worth of items.
+// For small or cache-resident views the plain loop is just as fast.
 //
-template<typename ArrayType, std::size_t ArraySize>
-array_view<ArrayType> make_array_view(ArrayType (&arr)[ArraySize]) noexcept
-{
-    return { arr, ArraySize };
-}
-template<typename ArrayType>
-array_view<ArrayType> make_array_view(ArrayType * array_ptr, const std::size_t size_in_items) noexcept
+//  for_each_prefetched(normals, [&](const Vec3 & n) { ... });
+//
+template<typename T, std::size_t Extent, typename Func>
+Func for_each_prefetched(array_view<T, Extent> view, Func func, const std::size_t distance_items = 0)
 {
-    return { array_ptr, size_in_items };
+    using byte_type = typename std::conditional<std::is_const<T>::value, const std::uint8_t, std::uint8_t>::type;
+    array_view_detail::prefetched_scan<T>(reinterpret_cast<byte_type *>(view.data()), sizeof(T),
+                                          view.size(), distance_items, func);
+    return func;
 }
-template<typename ContainerType>
-array_view<typename ContainerType::value_type> make_array_view(ContainerType & container) noexcept
+
+template<typename T, std::size_t OffsetBytes, std::size_t StrideBytes, typename Func>
+Func for_each_prefetched(strided_array_view<T, OffsetBytes, StrideBytes> view, Func func, const std::size_t distance_items = 0)
 {
-    return array_view<typename ContainerType::value_type>{ container };
+    if (!view.empty())
+    {
+        array_view_detail::prefetched_scan<T>(view.get_item_raw_ptr(0), view.stride_bytes(),
+                                              view.size(), distance_items, func);
+    }
+    return func;
 }
 
 // ========================================================
-// template class strided_array_view:
+// template class array_view_2d:
 // ========================================================
 
 //
-// Experimental strided_array_view.
-// Allows accessing members of structured types as
-// if it was an array_view of the member type itself.
+// Memory layouts for array_view_2d. Strides are in items, not bytes.
 //
-// See the example code below for a reference.
+struct layout_row_major { }; // Items of a row are adjacent, rows are row_stride() items apart.
+struct layout_col_major { }; // Items of a column are adjacent, columns are col_stride() items apart.
+struct layout_strided   { }; // Arbitrary row_stride() and col_stride().
+
+namespace array_view_detail
+{
+    // Extent holder that can appear twice as a (distinct) empty base of
+    // the same class. Same as extent_storage, with a tag to tell them apart.
+    template<std::size_t Extent, int Tag>
+    class tagged_extent_storage
+    {
+    public:
+        constexpr tagged_extent_storage() noexcept { }
+        constexpr explicit tagged_extent_storage(std::size_t) noexcept { }
+        constexpr std::size_t stored_extent() const noexcept { return Extent; }
+    };
+
+    template<int Tag>
+    class tagged_extent_storage<dynamic_extent, Tag>
+    {
+    public:
+        constexpr tagged_extent_storage() noexcept : m_extent{ 0 } { }
+        constexpr explicit tagged_extent_storage(const std::size_t extent) noexcept : m_extent{ extent } { }
+        constexpr std::size_t stored_extent() const noexcept { return m_extent; }
+    private:
+        std::size_t m_extent;
+    };
+
+    // Row and column strides of an array_view_2d. The stride that
+    // is always 1 for the layout is a constant, the others are stored.
+    template<typename Layout>
+    class layout_storage;
+
+    template<>
+    class layout_storage<layout_row_major>
+    {
+    public:
+        constexpr layout_storage() noexcept : m_row_stride{ 0 } { }
+        constexpr layout_storage(const std::size_t row_stride, std::size_t) noexcept : m_row_stride{ row_stride } { }
+        constexpr std::size_t row_stride() const noexcept { return m_row_stride; }
+        static constexpr std::size_t col_stride() noexcept { return 1; }
+    private:
+        std::size_t m_row_stride;
+    };
+
+    template<>
+    class layout_storage<layout_col_major>
+    {
+    public:
+        constexpr layout_storage() noexcept : m_col_stride{ 0 } { }
+        constexpr layout_storage(std::size_t, const std::size_t col_stride) noexcept : m_col_stride{ col_stride } { }
+        static constexpr std::size_t row_stride() noexcept { return 1; }
+        constexpr std::size_t col_stride() const noexcept { return m_col_stride; }
+    private:
+        std::size_t m_col_stride;
+    };
+
+    template<>
+    class layout_storage<layout_strided>
+    {
+    public:
+        constexpr layout_storage() noexcept : m_row_stride{ 0 }, m_col_stride{ 0 } { }
+        constexpr layout_storage(const std::size_t row_stride, const std::size_t col_stride) noexcept
+            : m_row_stride{ row_stride }, m_col_stride{ col_stride } { }
+        constexpr std::size_t row_stride() const noexcept { return m_row_stride; }
+        constexpr std::size_t col_stride() const noexcept { return m_col_stride; }
+    private:
+        std::size_t m_row_stride;
+        std::size_t m_col_stride;
+    };
+
+    // Type of a single row/column: contiguous array_view when the
+    // layout guarantees it, runtime strided view otherwise.
+    template<typename T, std::size_t Extent, bool Contiguous>
+    struct line_view_type
+    {
+        using type = dynamic_strided_array_view<T>;
+    };
+    template<typename T, std::size_t Extent>
+    struct line_view_type<T, Extent, true>
+    {
+        using type = array_view<T, Extent>;
+    };
+} // namespace array_view_detail {}
+
+//
+// Two-dimensional non-owning view over rows x cols items, for images,
+// matrices and other tensors that would otherwise need hand-written
+// y * width + x arithmetic. Rows and Cols can be compile-time extents.
+// row(), col(), subview() and tile() are views of the same memory,
+// nothing is ever copied.
+//
+//  auto image = array_view_2d<float>(pixels, height, width);
+//  image(y, x) = 1.0f;
+//  image.for_each_tile(32, 64 / sizeof(float), [](array_view_2d<float> tile) { ... });
 //
 template
 <
     typename T,
-    std::size_t OffsetBytes,
-    std::size_t StrideBytes
+    std::size_t Rows   = dynamic_extent,
+    std::size_t Cols   = dynamic_extent,
+    typename    Layout = layout_row_major
 >
-class strided_array_view final
+class array_view_2d final
+    : private array_view_detail::tagged_extent_storage<Rows, 0>
+    , private array_view_detail::tagged_extent_storage<Cols, 1>
+    , private array_view_detail::layout_storage<Layout>
 {
+    using rows_storage_type   = array_view_detail::tagged_extent_storage<Rows, 0>;
+    using cols_storage_type   = array_view_detail::tagged_extent_storage<Cols, 1>;
+    using layout_storage_type = array_view_detail::layout_storage<Layout>;
+
 public:
 
     //
@@ -789,6 +4488,7 @@ public:
     //
 
     using value_type      = T;
+    using layout_type     = Layout;
     using size_type       = std::size_t;
     using difference_type = std::ptrdiff_t;
 
@@ -797,177 +4497,354 @@ public:
     using const_pointer   = typename std::add_pointer<const value_type>::type;
     using const_reference = typename std::add_lvalue_reference<const value_type>::type;
 
-    using byte_type       = typename std::conditional<std::is_const<value_type>::value, const std::uint8_t, std::uint8_t>::type;
-    using byte_ptr_type   = typename std::add_pointer<byte_type>::type;
+    using row_view_type   = typename array_view_detail::line_view_type<value_type, Cols, std::is_same<Layout, layout_row_major>::value>::type;
+    using col_view_type   = typename array_view_detail::line_view_type<value_type, Rows, std::is_same<Layout, layout_col_major>::value>::type;
+    using subview_type    = array_view_2d<value_type, dynamic_extent, dynamic_extent, Layout>;
+
+    static constexpr size_type rows_extent = Rows;
+    static constexpr size_type cols_extent = Cols;
 
     //
     // Constructors / assignment:
     //
 
-    strided_array_view() noexcept
-        : m_pointer{ nullptr }
-        , m_size_in_bytes{ 0 }
+    template
+    <
+        size_type R = Rows,
+        size_type C = Cols,
+        typename std::enable_if<(R == dynamic_extent || R == 0) && (C == dynamic_extent || C == 0), int>::type = 0
+    >
+    constexpr array_view_2d() noexcept
+        : rows_storage_type{ 0 }
+        , cols_storage_type{ 0 }
+        , layout_storage_type{ 0, 0 }
+        , m_pointer{ nullptr }
     { }
 
-    template<typename StructuredType>
-    strided_array_view(StructuredType * array_ptr, const size_type size_in_items) noexcept
-        : m_pointer{ reinterpret_cast<byte_ptr_type>(array_ptr) }
-        , m_size_in_bytes{ size_in_items * sizeof(StructuredType) }
-    { }
-
-    strided_array_view(const strided_array_view & other) = default;
-    strided_array_view & operator = (const strided_array_view & other) = default;
-
-    //
-    // Miscellaneous queries:
-    //
-
-    byte_ptr_type data() const noexcept
+    // Dense rows x cols block in the given layout.
+    ARRAY_VIEW_CONSTEXPR array_view_2d(pointer data_ptr, const size_type num_rows, const size_type num_cols) ARRAY_VIEW_UNCHECKED_NOEXCEPT
+        : rows_storage_type{ num_rows }
+        , cols_storage_type{ num_cols }
+        , layout_storage_type{ std::is_same<Layout, layout_col_major>::value ? 1 : num_cols,
+                               std::is_same<Layout, layout_col_major>::value ? num_rows : 1 }
+        , m_pointer{ data_ptr }
     {
-        return m_pointer;
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        check_extents(num_rows, num_cols);
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
     }
-    byte_ptr_type data() noexcept
+
+    // Explicit strides (in items). Row-major views ignore col_stride_items
+    // and column-major views ignore row_stride_items, which are always 1.
+    // Use this for padded images (row pitch greater than the width).
+    ARRAY_VIEW_CONSTEXPR array_view_2d(pointer data_ptr, const size_type num_rows, const size_type num_cols,
+                                       const size_type row_stride_items, const size_type col_stride_items) ARRAY_VIEW_UNCHECKED_NOEXCEPT
+        : rows_storage_type{ num_rows }
+        , cols_storage_type{ num_cols }
+        , layout_storage_type{ row_stride_items, col_stride_items }
+        , m_pointer{ data_ptr }
     {
-        return m_pointer;
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        check_extents(num_rows, num_cols);
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
     }
-    bool empty() const noexcept
+
+    // Dense block over an array_view, which must hold exactly rows x cols items.
+    template<typename ConvertibleType, std::size_t Extent>
+    ARRAY_VIEW_CONSTEXPR array_view_2d(array_view<ConvertibleType, Extent> items, const size_type num_rows, const size_type num_cols) ARRAY_VIEW_UNCHECKED_NOEXCEPT
+        : array_view_2d{ items.data(), num_rows, num_cols }
     {
-        return size_bytes() == 0;
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (items.size() != num_rows * num_cols)
+        {
+            ARRAY_VIEW_ERROR("array_view_2d: rows * cols doesn't match the array_view size!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
     }
-    size_type size_bytes() const noexcept
+
+    // T to const T and static to dynamic extents, same layout.
+    template
+    <
+        typename ConvertibleType,
+        std::size_t OtherRows,
+        std::size_t OtherCols,
+        typename std::enable_if<std::is_convertible<ConvertibleType *, pointer>::value &&
+                                (Rows == dynamic_extent || Rows == OtherRows) &&
+                                (Cols == dynamic_extent || Cols == OtherCols), int>::type = 0
+    >
+    ARRAY_VIEW_CONSTEXPR array_view_2d(const array_view_2d<ConvertibleType, OtherRows, OtherCols, Layout> & other) noexcept
+        : rows_storage_type{ other.rows() }
+        , cols_storage_type{ other.cols() }
+        , layout_storage_type{ other.row_stride(), other.col_stride() }
+        , m_pointer{ other.data() }
+    { }
+
+    //
+    // Sub-views:
+    //
+
+    // Row index as a contiguous array_view for row-major layouts, strided view otherwise.
+    ARRAY_VIEW_CONSTEXPR row_view_type row(const size_type row_index) const
     {
-        return m_size_in_bytes;
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (row_index >= rows())
+        {
+            ARRAY_VIEW_ERROR("array_view_2d::row(): row index is out-of-bounds!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return make_line<row_view_type>(m_pointer + row_index * row_stride(), cols(), col_stride());
     }
-    size_type size() const noexcept
+
+    // Column index as a contiguous array_view for column-major layouts, strided view otherwise.
+    ARRAY_VIEW_CONSTEXPR col_view_type col(const size_type col_index) const
     {
-        return size_bytes() / stride_bytes();
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (col_index >= cols())
+        {
+            ARRAY_VIEW_ERROR("array_view_2d::col(): column index is out-of-bounds!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return make_line<col_view_type>(m_pointer + col_index * col_stride(), rows(), row_stride());
     }
 
-    static constexpr size_type offset_bytes() noexcept { return OffsetBytes; }
-    static constexpr size_type stride_bytes() noexcept { return StrideBytes; }
+    // num_rows x num_cols block starting at (first_row, first_col).
+    ARRAY_VIEW_CONSTEXPR subview_type subview(const size_type first_row, const size_type first_col,
+                                              const size_type num_rows, const size_type num_cols) const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (first_row + num_rows > rows() || first_col + num_cols > cols())
+        {
+            ARRAY_VIEW_ERROR("array_view_2d::subview(): block is out-of-bounds!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
 
-    //
-    // Compare against nullptr (test for a null strided_array_view):
-    //
+        return subview_type{ m_pointer + offset_of(first_row, first_col), num_rows, num_cols, row_stride(), col_stride() };
+    }
 
-    bool operator == (std::nullptr_t) const noexcept
+    // Fixed-size TileRows x TileCols block, with static extents.
+    template<size_type TileRows, size_type TileCols>
+    ARRAY_VIEW_CONSTEXPR array_view_2d<value_type, TileRows, TileCols, Layout> tile(const size_type first_row, const size_type first_col) const
     {
-        return data() == nullptr;
+        static_assert(Rows == dynamic_extent || TileRows <= Rows, "array_view_2d::tile(): tile has more rows than the view!");
+        static_assert(Cols == dynamic_extent || TileCols <= Cols, "array_view_2d::tile(): tile has more columns than the view!");
+
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (first_row + TileRows > rows() || first_col + TileCols > cols())
+        {
+            ARRAY_VIEW_ERROR("array_view_2d::tile(): block is out-of-bounds!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return array_view_2d<value_type, TileRows, TileCols, Layout>{
+            m_pointer + offset_of(first_row, first_col), TileRows, TileCols, row_stride(), col_stride() };
     }
-    bool operator != (std::nullptr_t) const noexcept
+
+    // Calls func(subview_type) for every tile_rows x tile_cols block, in
+    // memory order for the layout. Blocks on the right and bottom edges
+    // are smaller if the extents are not multiples of the tile size.
+    // Pick tile_cols * sizeof(T) (row-major) as a multiple of the cache
+    // line size to keep each tile row on whole cache lines.
+    template<typename Func>
+    void for_each_tile(const size_type tile_rows, const size_type tile_cols, Func && func) const
     {
-        return !(*this == nullptr);
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (tile_rows == 0 || tile_cols == 0)
+        {
+            ARRAY_VIEW_ERROR("array_view_2d::for_each_tile(): zero tile size!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        const size_type num_rows = rows();
+        const size_type num_cols = cols();
+
+        if (std::is_same<Layout, layout_col_major>::value)
+        {
+            for (size_type c = 0; c < num_cols; c += tile_cols)
+            {
+                for (size_type r = 0; r < num_rows; r += tile_rows)
+                {
+                    func(subview(r, c, std::min(tile_rows, num_rows - r), std::min(tile_cols, num_cols - c)));
+                }
+            }
+        }
+        else
+        {
+            for (size_type r = 0; r < num_rows; r += tile_rows)
+            {
+                for (size_type c = 0; c < num_cols; c += tile_cols)
+                {
+                    func(subview(r, c, std::min(tile_rows, num_rows - r), std::min(tile_cols, num_cols - c)));
+                }
+            }
+        }
     }
 
     //
     // Data access:
     //
 
-    const_reference at(const size_type index) const
+    ARRAY_VIEW_CONSTEXPR const_reference at(const size_type row_index, const size_type col_index) const
     {
-        // at() always validates the bounds.
-        if (data() == nullptr)
+        // Always checked.
+        if (m_pointer == nullptr)
         {
-            ARRAY_VIEW_ERROR("strided_array_view: null pointer!");
+            ARRAY_VIEW_ERROR("array_view_2d: null pointer!");
         }
-        if (index >= size())
+        if (row_index >= rows() || col_index >= cols())
         {
-            ARRAY_VIEW_ERROR("strided_array_view::at(): index is out-of-bounds!");
+            ARRAY_VIEW_ERROR("array_view_2d::at(): index is out-of-bounds!");
         }
-
-        return *reinterpret_cast<const_pointer>(get_item_raw_ptr(index));
+        return m_pointer[offset_of(row_index, col_index)];
     }
-    reference at(const size_type index)
+    ARRAY_VIEW_CONSTEXPR reference at(const size_type row_index, const size_type col_index)
     {
         // Always checked.
-        if (data() == nullptr)
+        if (m_pointer == nullptr)
         {
-            ARRAY_VIEW_ERROR("strided_array_view: null pointer!");
+            ARRAY_VIEW_ERROR("array_view_2d: null pointer!");
         }
-        if (index >= size())
+        if (row_index >= rows() || col_index >= cols())
         {
-            ARRAY_VIEW_ERROR("strided_array_view::at(): index is out-of-bounds!");
+            ARRAY_VIEW_ERROR("array_view_2d::at(): index is out-of-bounds!");
         }
-
-        return *reinterpret_cast<pointer>(get_item_raw_ptr(index));
+        return m_pointer[offset_of(row_index, col_index)];
     }
 
-    const_reference operator[](const size_type index) const
+    ARRAY_VIEW_CONSTEXPR const_reference operator()(const size_type row_index, const size_type col_index) const
     {
         #if ARRAY_VIEW_DEBUG_CHECKS
-        if (data() == nullptr)
+        if (m_pointer == nullptr)
         {
-            ARRAY_VIEW_ERROR("strided_array_view: null pointer!");
+            ARRAY_VIEW_ERROR("array_view_2d: null pointer!");
         }
-        if (index >= size())
+        if (row_index >= rows() || col_index >= cols())
         {
-            ARRAY_VIEW_ERROR("strided_array_view::operator[]: index is out-of-bounds!");
+            ARRAY_VIEW_ERROR("array_view_2d::operator(): index is out-of-bounds!");
         }
         #endif // ARRAY_VIEW_DEBUG_CHECKS
 
-        return *reinterpret_cast<const_pointer>(get_item_raw_ptr(index));
+        return m_pointer[offset_of(row_index, col_index)];
     }
-    reference operator[](const size_type index)
+    ARRAY_VIEW_CONSTEXPR reference operator()(const size_type row_index, const size_type col_index)
     {
         #if ARRAY_VIEW_DEBUG_CHECKS
-        if (data() == nullptr)
+        if (m_pointer == nullptr)
         {
-            ARRAY_VIEW_ERROR("strided_array_view: null pointer!");
+            ARRAY_VIEW_ERROR("array_view_2d: null pointer!");
         }
-        if (index >= size())
+        if (row_index >= rows() || col_index >= cols())
         {
-            ARRAY_VIEW_ERROR("strided_array_view::operator[]: index is out-of-bounds!");
+            ARRAY_VIEW_ERROR("array_view_2d::operator(): index is out-of-bounds!");
         }
         #endif // ARRAY_VIEW_DEBUG_CHECKS
 
-        return *reinterpret_cast<pointer>(get_item_raw_ptr(index));
+        return m_pointer[offset_of(row_index, col_index)];
     }
 
-    // These are never checked. Use at your own risk.
-    byte_ptr_type get_item_raw_ptr(const size_type index) noexcept
+    // Whole view as a flat array_view, only valid if is_contiguous().
+    ARRAY_VIEW_CONSTEXPR array_view<value_type> as_array_view() const
     {
-        return m_pointer + (index * stride_bytes()) + offset_bytes();
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (!is_contiguous())
+        {
+            ARRAY_VIEW_ERROR("array_view_2d::as_array_view(): items are not contiguous!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return array_view<value_type>{ m_pointer, size() };
     }
-    byte_ptr_type get_item_raw_ptr(const size_type index) const noexcept
+
+    //
+    // Miscellaneous queries:
+    //
+
+    constexpr size_type rows() const noexcept { return rows_storage_type::stored_extent(); }
+    constexpr size_type cols() const noexcept { return cols_storage_type::stored_extent(); }
+    constexpr size_type size() const noexcept { return rows() * cols(); }
+    constexpr bool empty() const noexcept { return size() == 0; }
+    constexpr pointer data() const noexcept { return m_pointer; }
+
+    // Distance in items between vertically/horizontally adjacent items.
+    using layout_storage_type::row_stride;
+    using layout_storage_type::col_stride;
+
+    // True if the items form a single dense block with no padding.
+    constexpr bool is_contiguous() const noexcept
     {
-        return m_pointer + (index * stride_bytes()) + offset_bytes();
+        return (std::is_same<Layout, layout_col_major>::value)
+            ? (cols() <= 1 || col_stride() == rows()) && row_stride() == 1
+            : (rows() <= 1 || row_stride() == cols()) && (cols() <= 1 || col_stride() == 1);
     }
 
-    reference front()
+    ARRAY_VIEW_CONSTEXPR bool operator == (std::nullptr_t) const noexcept
     {
-        return operator[](0);
+        return m_pointer == nullptr;
     }
-    const_reference front() const
+    ARRAY_VIEW_CONSTEXPR bool operator != (std::nullptr_t) const noexcept
     {
-        return operator[](0);
+        return m_pointer != nullptr;
     }
 
-    reference back()
+private:
+
+    #if ARRAY_VIEW_DEBUG_CHECKS
+    ARRAY_VIEW_CONSTEXPR void check_extents(const size_type num_rows, const size_type num_cols) const
     {
-        return operator[](size() - 1);
+        if ((Rows != dynamic_extent && num_rows != Rows) || (Cols != dynamic_extent && num_cols != Cols))
+        {
+            ARRAY_VIEW_ERROR("array_view_2d size doesn't match the static extents!");
+        }
     }
-    const_reference back() const
+    #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+    constexpr size_type offset_of(const size_type row_index, const size_type col_index) const noexcept
     {
-        return operator[](size() - 1);
+        return row_index * row_stride() + col_index * col_stride();
     }
 
-    //
-    // Non-throwing swap() overload for strided_array_view:
-    //
-
-    friend void swap(strided_array_view & lhs, strided_array_view & rhs) noexcept
+    template<typename LineView>
+    static ARRAY_VIEW_CONSTEXPR LineView make_line(pointer first, const size_type count, const size_type /*stride*/,
+                                                   typename std::enable_if<!std::is_same<LineView, dynamic_strided_array_view<value_type>>::value>::type * = nullptr) noexcept
     {
-        using std::swap;
-        swap(lhs.m_pointer, rhs.m_pointer);
-        swap(lhs.m_size_in_bytes, rhs.m_size_in_bytes);
+        return LineView{ first, count };
     }
 
-private:
+    template<typename LineView>
+    static LineView make_line(pointer first, const size_type count, const size_type stride,
+                              typename std::enable_if<std::is_same<LineView, dynamic_strided_array_view<value_type>>::value>::type * = nullptr) noexcept
+    {
+        // Strided views need a non-zero stride even for a single item.
+        const size_type stride_items = (stride != 0) ? stride : 1;
+        return LineView{ first, count * stride_items, 0, stride_items * sizeof(value_type) };
+    }
 
-    byte_ptr_type m_pointer;
-    size_type m_size_in_bytes;
+    pointer m_pointer;
 };
 
+template<typename T, std::size_t Rows, std::size_t Cols, typename Layout>
+constexpr std::size_t array_view_2d<T, Rows, Cols, Layout>::rows_extent;
+
+template<typename T, std::size_t Rows, std::size_t Cols, typename Layout>
+constexpr std::size_t array_view_2d<T, Rows, Cols, Layout>::cols_extent;
+
+// ========================================================
+// make_array_view_2d() helpers:
+// ========================================================
+
+template<typename T>
+ARRAY_VIEW_CONSTEXPR array_view_2d<T> make_array_view_2d(T * array_ptr, const std::size_t num_rows, const std::size_t num_cols) noexcept
+{
+    return array_view_2d<T>{ array_ptr, num_rows, num_cols };
+}
+
+template<typename T, std::size_t Rows, std::size_t Cols>
+ARRAY_VIEW_CONSTEXPR array_view_2d<T, Rows, Cols> make_array_view_2d(T (&arr)[Rows][Cols]) noexcept
+{
+    return array_view_2d<T, Rows, Cols>{ &arr[0][0], Rows, Cols };
+}
+
 // ========================================================
 // strided_array_view usage example:
 // ========================================================
@@ -1039,6 +4916,27 @@ void strided_array_view_example()
     assert(std::memcmp(&sav2.back(),  &verts[5].normal,    sizeof(Vec3)) == 0);
     assert(std::memcmp(&sav3.front(), &verts[0].texcoords, sizeof(Vec2)) == 0);
     assert(std::memcmp(&sav3.back(),  &verts[5].texcoords, sizeof(Vec2)) == 0);
+
+    // Iterators step from one structure to the next, so the
+    // views work with range-based for and the Standard algorithms.
+    std::size_t n = 0;
+    for (const Vec3 & normal : sav2)
+    {
+        assert(std::memcmp(&normal, &verts[n++].normal, sizeof(Vec3)) == 0);
+    }
+    assert(n == sav2.size());
+    assert(std::distance(sav3.begin(), sav3.end()) == 6);
+    assert(std::memcmp(&*sav3.rbegin(), &verts[5].texcoords, sizeof(Vec2)) == 0);
+
+    // Same as sav2 but with the layout supplied at runtime.
+    // Compile-time views also convert implicitly to this form.
+    auto dsav = dynamic_strided_array_view<const Vec3>(verts, array_size(verts), sizeof(Vec3), sizeof(Vertex));
+    dynamic_strided_array_view<const Vec3> dsav2 = sav2;
+
+    assert(dsav.size() == sav2.size());
+    assert(dsav.offset_bytes() == dsav2.offset_bytes());
+    assert(dsav.stride_bytes() == dsav2.stride_bytes());
+    assert(&dsav.back() == &sav2.back());
 }
 #endif // 0
 
@@ -0,0 +1,528 @@
+// ================================================================================================
+// -*- C++ -*-
+// File: array_view_adaptors.hpp
+// Author: Guilherme R. Lampert
+// Created on: 14/10/26
+//
+// About:
+//  Lazy view adaptors over array_view, strided_array_view and each other:
+//  transform_view, filter_view, zip_view and enumerate_view. Nothing is
+//  materialized, items are computed as they are read, so a pipeline of
+//  adaptors compiles down to a single loop over the source views.
+//
+// License:
+//  This software is in the public domain. Where that dedication is not recognized,
+//  you are granted a perpetual, irrevocable license to copy, distribute, and modify
+//  this file as you see fit. Source code is provided "as is", without warranty of any
+//  kind, express or implied. No attribution is required, but a mention about the author
+//  is appreciated.
+// ================================================================================================
+
+#ifndef ARRAY_VIEW_ADAPTORS_HPP
+#define ARRAY_VIEW_ADAPTORS_HPP
+
+#include "array_view.hpp"
+
+#ifndef ARRAY_VIEW_NO_STD_INCLUDES
+    #include <tuple>
+#endif // ARRAY_VIEW_NO_STD_INCLUDES
+
+//
+// Adaptors store the views they wrap by value (views are cheap to copy)
+// and their iterators wrap the wrapped view's iterators, taking on their
+// category. Over array_view and strided_array_view that is random access,
+// and transform_view, zip_view and enumerate_view keep it, along with
+// size() and operator[]. filter_view is forward only and unsized, and so
+// is anything built on top of it.
+//
+// Functions are called through a const reference, so they must be const
+// callable (plain lambdas are). Items are returned by value if the
+// function returns by value, so the iterators are proxy iterators like
+// std::vector<bool>'s: fine for loops and most algorithms, but the
+// result of *it can't always be bound to a non-const reference.
+//
+// As with the other views, an adaptor must outlive its iterators.
+// In C++17 the class names work as factories through class template
+// argument deduction; the make_*() functions cover C++11/14:
+//
+//  auto samples = make_transform_view(make_array_view(raw),
+//                                     [](std::uint16_t s) { return s * (1.0f / 65535.0f); });
+//  for (auto [index, sample] : enumerate_view(samples)) { ... }
+//
+// Mutable access goes through non-const adaptors, so writing through
+// the items works:
+//
+//  for (auto item : make_zip_view(make_array_view(dest), make_array_view(source)))
+//  {
+//      std::get<0>(item) = std::get<1>(item) * 2;
+//  }
+//
+
+namespace array_view_detail
+{
+    template<typename View>
+    using view_iterator_t = decltype(std::declval<View &>().begin());
+
+    template<typename Iterator>
+    using iterator_reference_t = typename std::iterator_traits<Iterator>::reference;
+
+    // Random access if every category allows it, forward otherwise.
+    template<typename... Categories>
+    struct common_iterator_category;
+
+    template<typename Category>
+    struct common_iterator_category<Category>
+    {
+        using type = typename std::conditional<std::is_base_of<std::random_access_iterator_tag, Category>::value,
+                                               std::random_access_iterator_tag, std::forward_iterator_tag>::type;
+    };
+
+    template<typename Category, typename... Others>
+    struct common_iterator_category<Category, Others...>
+    {
+        using type = typename std::conditional<std::is_same<typename common_iterator_category<Category>::type,
+                                                            std::random_access_iterator_tag>::value,
+                                               typename common_iterator_category<Others...>::type,
+                                               std::forward_iterator_tag>::type;
+    };
+} // namespace array_view_detail {}
+
+// ========================================================
+// template class transform_view:
+// ========================================================
+
+template<typename BaseIterator, typename Func>
+class transform_iterator final
+{
+public:
+
+    using iterator_category = typename array_view_detail::common_iterator_category<
+                                  typename std::iterator_traits<BaseIterator>::iterator_category>::type;
+    using reference         = decltype(std::declval<const Func &>()(*std::declval<BaseIterator &>()));
+    using value_type        = typename std::decay<reference>::type;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = void;
+
+    transform_iterator() = default;
+
+    transform_iterator(BaseIterator base, const Func * func)
+        : m_base{ base }
+        , m_func{ func }
+    { }
+
+    reference operator*() const { return (*m_func)(*m_base); }
+    reference operator[](const difference_type n) const { return (*m_func)(m_base[n]); }
+
+    transform_iterator & operator++() { ++m_base; return *this; }
+    transform_iterator & operator--() { --m_base; return *this; }
+    transform_iterator operator++(int) { transform_iterator temp{ *this }; ++m_base; return temp; }
+    transform_iterator operator--(int) { transform_iterator temp{ *this }; --m_base; return temp; }
+
+    transform_iterator & operator += (const difference_type n) { m_base += n; return *this; }
+    transform_iterator & operator -= (const difference_type n) { m_base -= n; return *this; }
+    transform_iterator operator + (const difference_type n) const { return transform_iterator{ m_base + n, m_func }; }
+    transform_iterator operator - (const difference_type n) const { return transform_iterator{ m_base - n, m_func }; }
+    friend transform_iterator operator + (const difference_type n, const transform_iterator & iter) { return iter + n; }
+    difference_type operator - (const transform_iterator & other) const { return m_base - other.m_base; }
+
+    bool operator == (const transform_iterator & other) const { return m_base == other.m_base; }
+    bool operator != (const transform_iterator & other) const { return m_base != other.m_base; }
+    bool operator <  (const transform_iterator & other) const { return m_base <  other.m_base; }
+    bool operator >  (const transform_iterator & other) const { return m_base >  other.m_base; }
+    bool operator <= (const transform_iterator & other) const { return m_base <= other.m_base; }
+    bool operator >= (const transform_iterator & other) const { return m_base >= other.m_base; }
+
+    const BaseIterator & base() const noexcept { return m_base; }
+
+private:
+
+    BaseIterator m_base{};
+    const Func * m_func = nullptr;
+};
+
+//
+// Items of View passed through func, computed on each access.
+//
+template<typename View, typename Func>
+class transform_view final
+{
+public:
+
+    using iterator       = transform_iterator<array_view_detail::view_iterator_t<View>, Func>;
+    using const_iterator = transform_iterator<array_view_detail::view_iterator_t<const View>, Func>;
+    using value_type     = typename iterator::value_type;
+    using size_type      = std::size_t;
+
+    transform_view(View view, Func func)
+        : m_view{ view }
+        , m_func{ func }
+    { }
+
+    iterator begin() { return iterator{ m_view.begin(), &m_func }; }
+    iterator end()   { return iterator{ m_view.end(),   &m_func }; }
+    const_iterator begin() const { return const_iterator{ m_view.begin(), &m_func }; }
+    const_iterator end()   const { return const_iterator{ m_view.end(),   &m_func }; }
+
+    // Random access views only:
+    size_type size() const { return m_view.size(); }
+    bool empty() const { return m_view.size() == 0; }
+    template<typename V = View>
+    auto operator[](const size_type index) -> decltype(std::declval<const Func &>()(std::declval<V &>()[index]))
+    {
+        return m_func(m_view[index]);
+    }
+    template<typename V = View>
+    auto operator[](const size_type index) const -> decltype(std::declval<const Func &>()(std::declval<const V &>()[index]))
+    {
+        return m_func(m_view[index]);
+    }
+
+    const View & base() const noexcept { return m_view; }
+
+private:
+
+    View m_view;
+    Func m_func;
+};
+
+template<typename View, typename Func>
+transform_view<View, Func> make_transform_view(View view, Func func)
+{
+    return transform_view<View, Func>{ view, func };
+}
+
+// ========================================================
+// template class filter_view:
+// ========================================================
+
+template<typename BaseIterator, typename Pred>
+class filter_iterator final
+{
+public:
+
+    using iterator_category = std::forward_iterator_tag;
+    using reference         = array_view_detail::iterator_reference_t<BaseIterator>;
+    using value_type        = typename std::iterator_traits<BaseIterator>::value_type;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = void;
+
+    filter_iterator() = default;
+
+    // Starts at the first item from current that satisfies pred.
+    filter_iterator(BaseIterator current, BaseIterator last, const Pred * pred)
+        : m_current{ current }
+        , m_last{ last }
+        , m_pred{ pred }
+    {
+        skip_rejected();
+    }
+
+    reference operator*() const { return *m_current; }
+
+    filter_iterator & operator++()
+    {
+        ++m_current;
+        skip_rejected();
+        return *this;
+    }
+    filter_iterator operator++(int)
+    {
+        filter_iterator temp{ *this };
+        ++(*this);
+        return temp;
+    }
+
+    bool operator == (const filter_iterator & other) const { return m_current == other.m_current; }
+    bool operator != (const filter_iterator & other) const { return m_current != other.m_current; }
+
+    const BaseIterator & base() const noexcept { return m_current; }
+
+private:
+
+    void skip_rejected()
+    {
+        while (m_current != m_last && !(*m_pred)(*m_current))
+        {
+            ++m_current;
+        }
+    }
+
+    BaseIterator m_current{};
+    BaseIterator m_last{};
+    const Pred * m_pred = nullptr;
+};
+
+//
+// Items of View for which pred returns true. Forward only: the
+// position of the n-th item isn't known without scanning, and
+// begin() scans for the first one on every call.
+//
+template<typename View, typename Pred>
+class filter_view final
+{
+public:
+
+    using iterator       = filter_iterator<array_view_detail::view_iterator_t<View>, Pred>;
+    using const_iterator = filter_iterator<array_view_detail::view_iterator_t<const View>, Pred>;
+    using value_type     = typename iterator::value_type;
+
+    filter_view(View view, Pred pred)
+        : m_view{ view }
+        , m_pred{ pred }
+    { }
+
+    iterator begin() { return iterator{ m_view.begin(), m_view.end(), &m_pred }; }
+    iterator end()   { return iterator{ m_view.end(),   m_view.end(), &m_pred }; }
+    const_iterator begin() const { return const_iterator{ m_view.begin(), m_view.end(), &m_pred }; }
+    const_iterator end()   const { return const_iterator{ m_view.end(),   m_view.end(), &m_pred }; }
+
+    bool empty() const { return begin() == end(); }
+
+    const View & base() const noexcept { return m_view; }
+
+private:
+
+    View m_view;
+    Pred m_pred;
+};
+
+template<typename View, typename Pred>
+filter_view<View, Pred> make_filter_view(View view, Pred pred)
+{
+    return filter_view<View, Pred>{ view, pred };
+}
+
+// ========================================================
+// template class zip_view:
+// ========================================================
+
+template<typename... BaseIterators>
+class zip_iterator final
+{
+public:
+
+    using iterator_category = typename array_view_detail::common_iterator_category<
+                                  typename std::iterator_traits<BaseIterators>::iterator_category...>::type;
+    using reference         = std::tuple<array_view_detail::iterator_reference_t<BaseIterators>...>;
+    using value_type        = reference;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = void;
+
+    zip_iterator() = default;
+
+    explicit zip_iterator(std::tuple<BaseIterators...> bases)
+        : m_bases{ bases }
+    { }
+
+    reference operator*() const { return deref(array_view_detail::make_index_sequence<sizeof...(BaseIterators)>{}); }
+    reference operator[](const difference_type n) const { return *(*this + n); }
+
+    zip_iterator & operator++() { return advance(1); }
+    zip_iterator & operator--() { return advance(-1); }
+    zip_iterator operator++(int) { zip_iterator temp{ *this }; advance(1); return temp; }
+    zip_iterator operator--(int) { zip_iterator temp{ *this }; advance(-1); return temp; }
+
+    zip_iterator & operator += (const difference_type n) { return advance(n); }
+    zip_iterator & operator -= (const difference_type n) { return advance(-n); }
+    zip_iterator operator + (const difference_type n) const { zip_iterator temp{ *this }; return temp.advance(n); }
+    zip_iterator operator - (const difference_type n) const { zip_iterator temp{ *this }; return temp.advance(-n); }
+    friend zip_iterator operator + (const difference_type n, const zip_iterator & iter) { return iter + n; }
+
+    // All bases move together, so the first one stands for the rest.
+    difference_type operator - (const zip_iterator & other) const { return std::get<0>(m_bases) - std::get<0>(other.m_bases); }
+
+    bool operator == (const zip_iterator & other) const { return std::get<0>(m_bases) == std::get<0>(other.m_bases); }
+    bool operator != (const zip_iterator & other) const { return std::get<0>(m_bases) != std::get<0>(other.m_bases); }
+    bool operator <  (const zip_iterator & other) const { return std::get<0>(m_bases) <  std::get<0>(other.m_bases); }
+    bool operator >  (const zip_iterator & other) const { return std::get<0>(m_bases) >  std::get<0>(other.m_bases); }
+    bool operator <= (const zip_iterator & other) const { return std::get<0>(m_bases) <= std::get<0>(other.m_bases); }
+    bool operator >= (const zip_iterator & other) const { return std::get<0>(m_bases) >= std::get<0>(other.m_bases); }
+
+private:
+
+    template<std::size_t... Is>
+    reference deref(array_view_detail::index_sequence<Is...>) const
+    {
+        return reference{ *std::get<Is>(m_bases)... };
+    }
+
+    zip_iterator & advance(const difference_type n)
+    {
+        advance_all(n, array_view_detail::make_index_sequence<sizeof...(BaseIterators)>{});
+        return *this;
+    }
+
+    template<std::size_t... Is>
+    void advance_all(const difference_type n, array_view_detail::index_sequence<Is...>)
+    {
+        (void)array_view_detail::swallow{ 0, (std::get<Is>(m_bases) += n, 0)... };
+    }
+
+    std::tuple<BaseIterators...> m_bases;
+};
+
+//
+// Items of several views side by side, as a std::tuple of their
+// references, so C++17 structured bindings can unpack them. The
+// views must be random access; the length is that of the shortest.
+//
+template<typename... Views>
+class zip_view final
+{
+    static_assert(sizeof...(Views) > 0, "zip_view needs at least one view!");
+
+public:
+
+    using iterator       = zip_iterator<array_view_detail::view_iterator_t<Views>...>;
+    using const_iterator = zip_iterator<array_view_detail::view_iterator_t<const Views>...>;
+    using value_type     = typename iterator::value_type;
+    using size_type      = std::size_t;
+
+    zip_view(Views... views)
+        : m_views{ views... }
+        , m_size{ min_size(views.size()...) }
+    { }
+
+    iterator begin() { return make_begin<iterator>(m_views, array_view_detail::make_index_sequence<sizeof...(Views)>{}); }
+    iterator end()   { return begin() + static_cast<std::ptrdiff_t>(m_size); }
+    const_iterator begin() const { return make_begin<const_iterator>(m_views, array_view_detail::make_index_sequence<sizeof...(Views)>{}); }
+    const_iterator end()   const { return begin() + static_cast<std::ptrdiff_t>(m_size); }
+
+    size_type size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+
+    template<typename It = iterator>
+    typename It::reference operator[](const size_type index) { return begin()[static_cast<std::ptrdiff_t>(index)]; }
+    template<typename It = const_iterator>
+    typename It::reference operator[](const size_type index) const { return begin()[static_cast<std::ptrdiff_t>(index)]; }
+
+private:
+
+    template<typename Iterator, typename Tuple, std::size_t... Is>
+    static Iterator make_begin(Tuple & views, array_view_detail::index_sequence<Is...>)
+    {
+        return Iterator{ std::make_tuple(std::get<Is>(views).begin()...) };
+    }
+
+    static size_type min_size(const size_type size) noexcept
+    {
+        return size;
+    }
+    template<typename... Sizes>
+    static size_type min_size(const size_type first, const Sizes... others) noexcept
+    {
+        const size_type rest = min_size(others...);
+        return (first < rest) ? first : rest;
+    }
+
+    std::tuple<Views...> m_views;
+    size_type m_size;
+};
+
+template<typename... Views>
+zip_view<Views...> make_zip_view(Views... views)
+{
+    return zip_view<Views...>{ views... };
+}
+
+// ========================================================
+// template class enumerate_view:
+// ========================================================
+
+template<typename BaseIterator>
+class enumerate_iterator final
+{
+public:
+
+    using iterator_category = typename array_view_detail::common_iterator_category<
+                                  typename std::iterator_traits<BaseIterator>::iterator_category>::type;
+    using reference         = std::pair<std::size_t, array_view_detail::iterator_reference_t<BaseIterator>>;
+    using value_type        = reference;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = void;
+
+    enumerate_iterator() = default;
+
+    enumerate_iterator(BaseIterator base, const std::size_t index)
+        : m_base{ base }
+        , m_index{ index }
+    { }
+
+    reference operator*() const { return reference{ m_index, *m_base }; }
+    reference operator[](const difference_type n) const { return reference{ m_index + n, m_base[n] }; }
+
+    enumerate_iterator & operator++() { ++m_base; ++m_index; return *this; }
+    enumerate_iterator & operator--() { --m_base; --m_index; return *this; }
+    enumerate_iterator operator++(int) { enumerate_iterator temp{ *this }; ++(*this); return temp; }
+    enumerate_iterator operator--(int) { enumerate_iterator temp{ *this }; --(*this); return temp; }
+
+    enumerate_iterator & operator += (const difference_type n) { m_base += n; m_index += n; return *this; }
+    enumerate_iterator & operator -= (const difference_type n) { m_base -= n; m_index -= n; return *this; }
+    enumerate_iterator operator + (const difference_type n) const { return enumerate_iterator{ m_base + n, m_index + n }; }
+    enumerate_iterator operator - (const difference_type n) const { return enumerate_iterator{ m_base - n, m_index - n }; }
+    friend enumerate_iterator operator + (const difference_type n, const enumerate_iterator & iter) { return iter + n; }
+    difference_type operator - (const enumerate_iterator & other) const { return m_base - other.m_base; }
+
+    bool operator == (const enumerate_iterator & other) const { return m_base == other.m_base; }
+    bool operator != (const enumerate_iterator & other) const { return m_base != other.m_base; }
+    bool operator <  (const enumerate_iterator & other) const { return m_base <  other.m_base; }
+    bool operator >  (const enumerate_iterator & other) const { return m_base >  other.m_base; }
+    bool operator <= (const enumerate_iterator & other) const { return m_base <= other.m_base; }
+    bool operator >= (const enumerate_iterator & other) const { return m_base >= other.m_base; }
+
+private:
+
+    BaseIterator m_base{};
+    std::size_t  m_index = 0; // Count of items yielded before this one.
+};
+
+//
+// Items of View as (index, item reference) pairs. Over a
+// filter_view the index counts the items that passed.
+//
+template<typename View>
+class enumerate_view final
+{
+public:
+
+    using iterator       = enumerate_iterator<array_view_detail::view_iterator_t<View>>;
+    using const_iterator = enumerate_iterator<array_view_detail::view_iterator_t<const View>>;
+    using value_type     = typename iterator::value_type;
+    using size_type      = std::size_t;
+
+    explicit enumerate_view(View view)
+        : m_view{ view }
+    { }
+
+    iterator begin() { return iterator{ m_view.begin(), 0 }; }
+    iterator end()   { return iterator{ m_view.end(), end_index(typename iterator::iterator_category{}) }; }
+    const_iterator begin() const { return const_iterator{ m_view.begin(), 0 }; }
+    const_iterator end()   const { return const_iterator{ m_view.end(), end_index(typename const_iterator::iterator_category{}) }; }
+
+    // Random access views only:
+    size_type size() const { return m_view.size(); }
+    bool empty() const { return m_view.size() == 0; }
+    template<typename It = iterator>
+    typename It::reference operator[](const size_type index) { return typename It::reference{ index, m_view[index] }; }
+    template<typename It = const_iterator>
+    typename It::reference operator[](const size_type index) const { return typename It::reference{ index, m_view[index] }; }
+
+    const View & base() const noexcept { return m_view; }
+
+private:
+
+    // Forward iterators only compare the base, and can't step back
+    // from end(), so their end index doesn't matter.
+    size_type end_index(std::random_access_iterator_tag) const { return static_cast<size_type>(m_view.end() - m_view.begin()); }
+    size_type end_index(std::forward_iterator_tag) const noexcept { return 0; }
+
+    View m_view;
+};
+
+template<typename View>
+enumerate_view<View> make_enumerate_view(View view)
+{
+    return enumerate_view<View>{ view };
+}
+
+#endif // ARRAY_VIEW_ADAPTORS_HPP
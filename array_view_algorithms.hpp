@@ -0,0 +1,802 @@
+// ================================================================================================
+// -*- C++ -*-
+// File: array_view_algorithms.hpp
+// Author: Guilherme R. Lampert
+// Created on: 14/10/26
+//
+// About:
+//  Parallel algorithms over array_view and strided_array_view: parallel_for,
+//  parallel_reduce, parallel_sum, parallel_min_max, parallel_sort (radix sort
+//  for integral keys) and binary searches over sorted views. The work is run
+//  by a pluggable executor, with a sequential one, a thread pool and, when
+//  enabled, one built on the C++17 parallel algorithms.
+//
+// License:
+//  This software is in the public domain. Where that dedication is not recognized,
+//  you are granted a perpetual, irrevocable license to copy, distribute, and modify
+//  this file as you see fit. Source code is provided "as is", without warranty of any
+//  kind, express or implied. No attribution is required, but a mention about the author
+//  is appreciated.
+// ================================================================================================
+
+#ifndef ARRAY_VIEW_ALGORITHMS_HPP
+#define ARRAY_VIEW_ALGORITHMS_HPP
+
+#include "array_view.hpp"
+
+//
+// Define this switch to nonzero to get std_execution_executor, which hands
+// tasks to std::for_each(std::execution::par, ...). Off by default since
+// <execution> is a heavy include and libstdc++ needs TBB to link it.
+//
+//#define ARRAY_VIEW_STD_EXECUTION 1
+
+#ifndef ARRAY_VIEW_NO_STD_INCLUDES
+    #include <mutex>
+    #include <atomic>
+    #include <memory>
+    #include <thread>
+    #include <vector>
+    #include <exception>
+    #include <condition_variable>
+    #if ARRAY_VIEW_STD_EXECUTION
+        #include <execution>
+    #endif // ARRAY_VIEW_STD_EXECUTION
+#endif // ARRAY_VIEW_NO_STD_INCLUDES
+
+// Items per task below which splitting the work further isn't worth it.
+#ifndef ARRAY_VIEW_PARALLEL_MIN_GRAIN
+    #define ARRAY_VIEW_PARALLEL_MIN_GRAIN 4096
+#endif // ARRAY_VIEW_PARALLEL_MIN_GRAIN
+
+// ========================================================
+// Executors:
+// ========================================================
+
+//
+// An executor is any object with:
+//
+//   std::size_t concurrency() const;
+//     How many tasks it can usefully run at once.
+//
+//   template<typename Func> void run(std::size_t task_count, Func && task);
+//     Calls task(i) for every i in [0, task_count), possibly concurrently,
+//     and returns when all calls have finished. An exception thrown by a
+//     task is rethrown from run().
+//
+// Algorithms split their input into about concurrency() tasks, never
+// smaller than ARRAY_VIEW_PARALLEL_MIN_GRAIN items, so wrapping an existing
+// job system only takes those two functions.
+//
+
+// Runs everything on the calling thread, in order.
+class sequential_executor final
+{
+public:
+
+    std::size_t concurrency() const noexcept
+    {
+        return 1;
+    }
+
+    template<typename Func>
+    void run(const std::size_t task_count, Func && task) const
+    {
+        for (std::size_t i = 0; i < task_count; ++i)
+        {
+            task(i);
+        }
+    }
+};
+
+//
+// Fixed set of worker threads. The thread calling run() works too, and
+// idle threads claim the next unstarted task from a shared counter, so
+// uneven tasks balance out. One run() at a time is active per pool (other
+// callers wait their turn) and a run() from inside one of the pool's own
+// tasks executes inline instead of deadlocking.
+//
+class thread_pool_executor final
+{
+public:
+
+    // thread_count includes the calling thread; 0 means hardware_concurrency().
+    explicit thread_pool_executor(std::size_t thread_count = 0)
+    {
+        if (thread_count == 0)
+        {
+            thread_count = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        }
+        m_workers.reserve(thread_count - 1);
+        for (std::size_t i = 1; i < thread_count; ++i)
+        {
+            m_workers.emplace_back([this]() { worker_loop(); });
+        }
+    }
+
+    ~thread_pool_executor()
+    {
+        {
+            std::lock_guard<std::mutex> lock{ m_mutex };
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto & worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    thread_pool_executor(const thread_pool_executor &) = delete;
+    thread_pool_executor & operator = (const thread_pool_executor &) = delete;
+
+    std::size_t concurrency() const noexcept
+    {
+        return m_workers.size() + 1;
+    }
+
+    template<typename Func>
+    void run(const std::size_t task_count, Func && task)
+    {
+        if (task_count == 0)
+        {
+            return;
+        }
+        if (task_count == 1 || m_workers.empty() || current_pool() == this)
+        {
+            for (std::size_t i = 0; i < task_count; ++i)
+            {
+                task(i);
+            }
+            return;
+        }
+
+        using func_type = typename std::remove_reference<Func>::type;
+        job current_job;
+        current_job.invoke     = [](void * context, const std::size_t index) { (*static_cast<func_type *>(context))(index); };
+        current_job.context    = static_cast<void *>(std::addressof(task));
+        current_job.task_count = task_count;
+
+        std::lock_guard<std::mutex> run_lock{ m_run_mutex };
+        {
+            std::lock_guard<std::mutex> lock{ m_mutex };
+            m_job = &current_job;
+            ++m_job_serial;
+        }
+        m_wake.notify_all();
+
+        execute(current_job);
+
+        // Every task is claimed now. Stop workers from joining, then
+        // wait for the ones still running theirs.
+        {
+            std::unique_lock<std::mutex> lock{ m_mutex };
+            m_job = nullptr;
+            m_job_done.wait(lock, [this]() { return m_active_workers == 0; });
+        }
+
+        if (current_job.error)
+        {
+            std::rethrow_exception(current_job.error);
+        }
+    }
+
+private:
+
+    struct job
+    {
+        void (*invoke)(void *, std::size_t) = nullptr;
+        void * context = nullptr;
+        std::size_t task_count = 0;
+        std::atomic<std::size_t> next_task{ 0 };
+        std::atomic<bool> failed{ false };
+        std::exception_ptr error;
+    };
+
+    static thread_pool_executor *& current_pool() noexcept
+    {
+        static thread_local thread_pool_executor * pool = nullptr;
+        return pool;
+    }
+
+    void execute(job & current_job) noexcept
+    {
+        thread_pool_executor * const previous_pool = current_pool();
+        current_pool() = this;
+
+        for (;;)
+        {
+            const std::size_t index = current_job.next_task.fetch_add(1, std::memory_order_relaxed);
+            if (index >= current_job.task_count || current_job.failed.load(std::memory_order_relaxed))
+            {
+                break;
+            }
+            try
+            {
+                current_job.invoke(current_job.context, index);
+            }
+            catch (...)
+            {
+                // Keep the first error; the remaining tasks are skipped.
+                if (!current_job.failed.exchange(true))
+                {
+                    current_job.error = std::current_exception();
+                }
+            }
+        }
+
+        current_pool() = previous_pool;
+    }
+
+    void worker_loop()
+    {
+        std::uint64_t last_serial = 0;
+        std::unique_lock<std::mutex> lock{ m_mutex };
+        for (;;)
+        {
+            m_wake.wait(lock, [this, last_serial]() { return m_stop || (m_job != nullptr && m_job_serial != last_serial); });
+            if (m_stop)
+            {
+                return;
+            }
+
+            job * const current_job = m_job;
+            last_serial = m_job_serial;
+            ++m_active_workers;
+            lock.unlock();
+
+            execute(*current_job);
+
+            lock.lock();
+            if (--m_active_workers == 0)
+            {
+                m_job_done.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> m_workers;
+    std::mutex               m_run_mutex;
+    std::mutex               m_mutex;
+    std::condition_variable  m_wake;
+    std::condition_variable  m_job_done;
+    job *                    m_job            = nullptr;
+    std::uint64_t            m_job_serial     = 0;
+    std::size_t              m_active_workers = 0;
+    bool                     m_stop           = false;
+};
+
+#if ARRAY_VIEW_STD_EXECUTION
+//
+// Runs the tasks with std::for_each(std::execution::par, ...),
+// leaving the scheduling to the Standard Library implementation.
+//
+class std_execution_executor final
+{
+public:
+
+    std::size_t concurrency() const noexcept
+    {
+        return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    template<typename Func>
+    void run(const std::size_t task_count, Func && task) const
+    {
+        std::for_each(std::execution::par, index_iterator{ 0 }, index_iterator{ task_count },
+                      [&task](const std::size_t index) { task(index); });
+    }
+
+private:
+
+    // Counts through the task indexes without storing them anywhere.
+    class index_iterator final
+    {
+    public:
+
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = std::size_t;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const std::size_t *;
+        using reference         = const std::size_t &;
+
+        index_iterator() noexcept = default;
+        explicit index_iterator(const std::size_t index) noexcept : m_index{ index } { }
+
+        reference operator*() const noexcept { return m_index; }
+        value_type operator[](const difference_type n) const noexcept { return m_index + n; }
+
+        index_iterator & operator++() noexcept { ++m_index; return *this; }
+        index_iterator & operator--() noexcept { --m_index; return *this; }
+        index_iterator operator++(int) noexcept { index_iterator temp{ *this }; ++m_index; return temp; }
+        index_iterator operator--(int) noexcept { index_iterator temp{ *this }; --m_index; return temp; }
+
+        index_iterator & operator += (const difference_type n) noexcept { m_index += n; return *this; }
+        index_iterator & operator -= (const difference_type n) noexcept { m_index -= n; return *this; }
+        index_iterator operator + (const difference_type n) const noexcept { return index_iterator{ m_index + n }; }
+        index_iterator operator - (const difference_type n) const noexcept { return index_iterator{ m_index - n }; }
+        friend index_iterator operator + (const difference_type n, const index_iterator & iter) noexcept { return iter + n; }
+        difference_type operator - (const index_iterator & other) const noexcept { return static_cast<difference_type>(m_index - other.m_index); }
+
+        bool operator == (const index_iterator & other) const noexcept { return m_index == other.m_index; }
+        bool operator != (const index_iterator & other) const noexcept { return m_index != other.m_index; }
+        bool operator <  (const index_iterator & other) const noexcept { return m_index <  other.m_index; }
+        bool operator >  (const index_iterator & other) const noexcept { return m_index >  other.m_index; }
+        bool operator <= (const index_iterator & other) const noexcept { return m_index <= other.m_index; }
+        bool operator >= (const index_iterator & other) const noexcept { return m_index >= other.m_index; }
+
+    private:
+
+        std::size_t m_index = 0;
+    };
+};
+#endif // ARRAY_VIEW_STD_EXECUTION
+
+// ========================================================
+// Algorithm helpers:
+// ========================================================
+
+namespace array_view_detail
+{
+
+// Number of tasks to split item_count items into for the executor.
+template<typename Executor>
+std::size_t parallel_task_count(const Executor & executor, const std::size_t item_count) noexcept
+{
+    const std::size_t max_tasks = (item_count + ARRAY_VIEW_PARALLEL_MIN_GRAIN - 1) / ARRAY_VIEW_PARALLEL_MIN_GRAIN;
+    return std::max<std::size_t>(std::min(executor.concurrency(), max_tasks), 1);
+}
+
+// Start of part part_index when splitting item_count items into part_count
+// even parts. Same split as array_view_partitions, minus the alignment.
+inline std::size_t part_boundary(const std::size_t item_count, const std::size_t part_count, const std::size_t part_index) noexcept
+{
+    return (item_count / part_count) * part_index + ((item_count % part_count) * part_index) / part_count;
+}
+
+// One task's partial result. Wrapped so a bool accumulator doesn't turn
+// the partials into a std::vector<bool>, whose items share words and
+// can't be written from different tasks.
+template<typename T>
+struct reduce_partial
+{
+    T value;
+};
+
+// Unsigned key whose natural order matches the order of the integral value.
+template<typename T>
+typename std::make_unsigned<T>::type radix_key(const T value) noexcept
+{
+    using key_type = typename std::make_unsigned<T>::type;
+    const key_type sign_flip = std::is_signed<T>::value ? static_cast<key_type>(key_type(1) << (sizeof(T) * 8 - 1)) : 0;
+    return static_cast<key_type>(static_cast<key_type>(value) ^ sign_flip);
+}
+
+// Stable LSD radix sort, 8 bits per pass, each pass counting and
+// scattering the parts in parallel. Passes where every key has the
+// same digit are skipped, so narrow value ranges sort quickly.
+template<typename Executor, typename T>
+void parallel_radix_sort(Executor && executor, array_view<T> view)
+{
+    const std::size_t item_count = view.size();
+    const std::size_t part_count = parallel_task_count(executor, item_count);
+    constexpr std::size_t radix  = 256;
+
+    std::unique_ptr<T[]> scratch{ new T[item_count] };
+    std::vector<std::size_t> offsets(part_count * radix);
+
+    T * source = view.data();
+    T * dest   = scratch.get();
+
+    for (std::size_t shift = 0; shift < sizeof(T) * 8; shift += 8)
+    {
+        std::fill(offsets.begin(), offsets.end(), std::size_t(0));
+        executor.run(part_count, [&](const std::size_t part) {
+            std::size_t * const counts = offsets.data() + part * radix;
+            const std::size_t last = part_boundary(item_count, part_count, part + 1);
+            for (std::size_t i = part_boundary(item_count, part_count, part); i < last; ++i)
+            {
+                ++counts[(radix_key(source[i]) >> shift) & (radix - 1)];
+            }
+        });
+
+        // Exclusive prefix sum in digit-major order, so that each part
+        // scatters right after the previous parts' items with the same digit.
+        bool single_digit = false;
+        std::size_t running_offset = 0;
+        for (std::size_t digit = 0; digit < radix && !single_digit; ++digit)
+        {
+            std::size_t digit_total = 0;
+            for (std::size_t part = 0; part < part_count; ++part)
+            {
+                std::size_t & slot = offsets[part * radix + digit];
+                const std::size_t count = slot;
+                slot = running_offset + digit_total;
+                digit_total += count;
+            }
+            single_digit = (digit_total == item_count);
+            running_offset += digit_total;
+        }
+        if (single_digit)
+        {
+            continue;
+        }
+
+        executor.run(part_count, [&](const std::size_t part) {
+            std::size_t * const part_offsets = offsets.data() + part * radix;
+            const std::size_t last = part_boundary(item_count, part_count, part + 1);
+            for (std::size_t i = part_boundary(item_count, part_count, part); i < last; ++i)
+            {
+                dest[part_offsets[(radix_key(source[i]) >> shift) & (radix - 1)]++] = source[i];
+            }
+        });
+        std::swap(source, dest);
+    }
+
+    if (source != view.data())
+    {
+        executor.run(part_count, [&](const std::size_t part) {
+            const std::size_t first = part_boundary(item_count, part_count, part);
+            const std::size_t last  = part_boundary(item_count, part_count, part + 1);
+            std::copy(source + first, source + last, view.data() + first);
+        });
+    }
+}
+
+// std::sort of each part in parallel, followed by rounds of pairwise
+// std::inplace_merge, doubling the width of the sorted runs each round.
+template<typename Executor, typename T, typename Compare>
+void parallel_merge_sort(Executor && executor, array_view<T> view, Compare compare)
+{
+    const std::size_t item_count = view.size();
+    const std::size_t part_count = parallel_task_count(executor, item_count);
+    T * const items = view.data();
+
+    executor.run(part_count, [&](const std::size_t part) {
+        std::sort(items + part_boundary(item_count, part_count, part),
+                  items + part_boundary(item_count, part_count, part + 1), compare);
+    });
+
+    for (std::size_t width = 1; width < part_count; width *= 2)
+    {
+        const std::size_t merge_count = (part_count + 2 * width - 1) / (2 * width);
+        executor.run(merge_count, [&](const std::size_t merge) {
+            const std::size_t first_part = merge * 2 * width;
+            const std::size_t mid_part   = std::min(first_part + width, part_count);
+            const std::size_t last_part  = std::min(first_part + 2 * width, part_count);
+            std::inplace_merge(items + part_boundary(item_count, part_count, first_part),
+                               items + part_boundary(item_count, part_count, mid_part),
+                               items + part_boundary(item_count, part_count, last_part), compare);
+        });
+    }
+}
+
+template<typename T>
+struct use_radix_sort
+    : std::integral_constant<bool, std::is_integral<T>::value && !std::is_same<T, bool>::value>
+{ };
+
+template<typename Executor, typename T>
+void parallel_sort_dispatch(Executor && executor, array_view<T> view, std::true_type /* radix */)
+{
+    parallel_radix_sort(executor, view);
+}
+
+template<typename Executor, typename T>
+void parallel_sort_dispatch(Executor && executor, array_view<T> view, std::false_type /* radix */)
+{
+    parallel_merge_sort(executor, view, std::less<T>{});
+}
+
+} // namespace array_view_detail
+
+// ========================================================
+// parallel_for() / parallel_reduce():
+// ========================================================
+
+//
+// Calls func(begin, end) over consecutive index ranges covering
+// [0, item_count), in parallel. The building block for the rest.
+//
+template<typename Executor, typename Func>
+void parallel_for_ranges(Executor && executor, const std::size_t item_count, Func func)
+{
+    const std::size_t task_count = array_view_detail::parallel_task_count(executor, item_count);
+    executor.run(task_count, [&](const std::size_t task) {
+        const std::size_t first = array_view_detail::part_boundary(item_count, task_count, task);
+        const std::size_t last  = array_view_detail::part_boundary(item_count, task_count, task + 1);
+        if (first != last)
+        {
+            func(first, last);
+        }
+    });
+}
+
+//
+// Calls func(item) for every item of the view, in parallel. Contiguous
+// views are split with partition_for_threads(), so tasks writing
+// through func don't share cache lines. Each task holds an
+// array_view_write_guard on its part (see ARRAY_VIEW_RACE_CHECKS).
+//
+template<typename Executor, typename T, std::size_t Extent, typename Func>
+void parallel_for(Executor && executor, array_view<T, Extent> view, Func func)
+{
+    const auto parts = view.partition_for_threads(array_view_detail::parallel_task_count(executor, view.size()));
+    executor.run(parts.size(), [&](const std::size_t part) {
+        const array_view_write_guard guard{ parts[part] };
+        for (auto & item : parts[part])
+        {
+            func(item);
+        }
+    });
+}
+
+// Strided views with a contiguous layout take the array_view path.
+template<typename Executor, typename T, std::size_t OffsetBytes, std::size_t StrideBytes, typename Func,
+         typename std::enable_if<!strided_array_view<T, OffsetBytes, StrideBytes>::is_contiguous, int>::type = 0>
+void parallel_for(Executor && executor, strided_array_view<T, OffsetBytes, StrideBytes> view, Func func)
+{
+    parallel_for_ranges(executor, view.size(), [&](const std::size_t first, const std::size_t last) {
+        for (std::size_t i = first; i < last; ++i)
+        {
+            func(view[i]);
+        }
+    });
+}
+
+template<typename Executor, typename T, std::size_t OffsetBytes, std::size_t StrideBytes, typename Func,
+         typename std::enable_if<strided_array_view<T, OffsetBytes, StrideBytes>::is_contiguous, int>::type = 0>
+void parallel_for(Executor && executor, strided_array_view<T, OffsetBytes, StrideBytes> view, Func func)
+{
+    parallel_for(executor, view.as_array_view(), std::move(func));
+}
+
+//
+// Folds the items with op, which must be associative, starting from init.
+// Each task folds its range from its first item, then the partial results
+// are folded onto init in order, so the result doesn't depend on timing.
+//
+// View is an array_view or strided_array_view (anything with size() and
+// operator[]).
+//
+template<typename Executor, typename View, typename T, typename BinaryOp>
+T parallel_reduce(Executor && executor, const View & view, T init, BinaryOp op)
+{
+    const std::size_t item_count = view.size();
+    const std::size_t task_count = array_view_detail::parallel_task_count(executor, item_count);
+
+    std::vector<array_view_detail::reduce_partial<T>> partials(task_count, array_view_detail::reduce_partial<T>{ init });
+    std::unique_ptr<bool[]> has_partial{ new bool[task_count]() };
+
+    executor.run(task_count, [&](const std::size_t task) {
+        const std::size_t first = array_view_detail::part_boundary(item_count, task_count, task);
+        const std::size_t last  = array_view_detail::part_boundary(item_count, task_count, task + 1);
+        if (first == last)
+        {
+            return;
+        }
+        T accumulator = view[first];
+        for (std::size_t i = first + 1; i < last; ++i)
+        {
+            accumulator = op(accumulator, view[i]);
+        }
+        partials[task].value = accumulator;
+        has_partial[task]    = true;
+    });
+
+    for (std::size_t task = 0; task < task_count; ++task)
+    {
+        if (has_partial[task])
+        {
+            init = op(init, partials[task].value);
+        }
+    }
+    return init;
+}
+
+// ========================================================
+// parallel_sum() / parallel_min_max():
+// ========================================================
+
+template<typename Executor, typename View>
+typename std::remove_const<typename View::value_type>::type
+parallel_sum(Executor && executor, const View & view)
+{
+    using value_type = typename std::remove_const<typename View::value_type>::type;
+    return parallel_reduce(executor, view, value_type{},
+                           [](const value_type & a, const value_type & b) { return a + b; });
+}
+
+template<typename T>
+struct min_max_result
+{
+    T min;
+    T max;
+};
+
+//
+// Smallest and biggest items of a non-empty view, using custom
+// min/max functions, e.g. component-wise ones for vectors. With a
+// strided view over a mesh's position channel this computes the
+// bounding box in place:
+//
+//  strided_array_view<const vec3, offsetof(vertex, position), sizeof(vertex)> positions{ vertices.data(), vertices.size() };
+//  auto bounds = parallel_min_max(pool, positions,
+//                                 [](const vec3 & a, const vec3 & b) { return min(a, b); },
+//                                 [](const vec3 & a, const vec3 & b) { return max(a, b); });
+//
+template<typename Executor, typename View, typename MinFunc, typename MaxFunc>
+min_max_result<typename std::remove_const<typename View::value_type>::type>
+parallel_min_max(Executor && executor, const View & view, MinFunc min_func, MaxFunc max_func)
+{
+    using value_type  = typename std::remove_const<typename View::value_type>::type;
+    using result_type = min_max_result<value_type>;
+
+    #if ARRAY_VIEW_DEBUG_CHECKS
+    if (view.size() == 0)
+    {
+        ARRAY_VIEW_ERROR("parallel_min_max() on an empty view!");
+    }
+    #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+    const std::size_t item_count = view.size();
+    const std::size_t task_count = array_view_detail::parallel_task_count(executor, item_count);
+    const result_type first_item{ view[0], view[0] };
+    std::vector<result_type> partials(task_count, first_item);
+
+    executor.run(task_count, [&](const std::size_t task) {
+        const std::size_t first = array_view_detail::part_boundary(item_count, task_count, task);
+        const std::size_t last  = array_view_detail::part_boundary(item_count, task_count, task + 1);
+        if (first == last)
+        {
+            return;
+        }
+        result_type bounds{ view[first], view[first] };
+        for (std::size_t i = first + 1; i < last; ++i)
+        {
+            const value_type & item = view[i];
+            bounds.min = min_func(bounds.min, item);
+            bounds.max = max_func(bounds.max, item);
+        }
+        partials[task] = bounds;
+    });
+
+    // Empty parts kept the first item, which is harmless here.
+    result_type result = first_item;
+    for (const result_type & bounds : partials)
+    {
+        result.min = min_func(result.min, bounds.min);
+        result.max = max_func(result.max, bounds.max);
+    }
+    return result;
+}
+
+// Same with operator <.
+template<typename Executor, typename View>
+min_max_result<typename std::remove_const<typename View::value_type>::type>
+parallel_min_max(Executor && executor, const View & view)
+{
+    using value_type = typename std::remove_const<typename View::value_type>::type;
+    return parallel_min_max(executor, view,
+                            [](const value_type & a, const value_type & b) -> const value_type & { return (b < a) ? b : a; },
+                            [](const value_type & a, const value_type & b) -> const value_type & { return (a < b) ? b : a; });
+}
+
+// ========================================================
+// parallel_sort():
+// ========================================================
+
+//
+// Sorts the view in ascending order. Integral items use a parallel
+// LSD radix sort (stable, needs a scratch copy of the view); other
+// types sort the parts with std::sort and merge them.
+//
+template<typename Executor, typename T, std::size_t Extent>
+void parallel_sort(Executor && executor, array_view<T, Extent> view)
+{
+    static_assert(!std::is_const<T>::value, "parallel_sort() needs a mutable view!");
+
+    if (view.size() < 2 * ARRAY_VIEW_PARALLEL_MIN_GRAIN)
+    {
+        std::sort(view.data(), view.data() + view.size());
+        return;
+    }
+    array_view_detail::parallel_sort_dispatch(executor, array_view<T>{ view }, array_view_detail::use_radix_sort<T>{});
+}
+
+// Comparison sort with a custom ordering. Not stable.
+template<typename Executor, typename T, std::size_t Extent, typename Compare>
+void parallel_sort(Executor && executor, array_view<T, Extent> view, Compare compare)
+{
+    static_assert(!std::is_const<T>::value, "parallel_sort() needs a mutable view!");
+
+    if (view.size() < 2 * ARRAY_VIEW_PARALLEL_MIN_GRAIN)
+    {
+        std::sort(view.data(), view.data() + view.size(), compare);
+        return;
+    }
+    array_view_detail::parallel_merge_sort(executor, array_view<T>{ view }, compare);
+}
+
+// Strided views can be sorted in place only if they are contiguous.
+template<typename Executor, typename T, std::size_t OffsetBytes, std::size_t StrideBytes>
+void parallel_sort(Executor && executor, strided_array_view<T, OffsetBytes, StrideBytes> view)
+{
+    static_assert(strided_array_view<T, OffsetBytes, StrideBytes>::is_contiguous,
+                  "parallel_sort() needs a contiguous view!");
+    parallel_sort(executor, view.as_array_view());
+}
+
+template<typename Executor, typename T, std::size_t OffsetBytes, std::size_t StrideBytes, typename Compare>
+void parallel_sort(Executor && executor, strided_array_view<T, OffsetBytes, StrideBytes> view, Compare compare)
+{
+    static_assert(strided_array_view<T, OffsetBytes, StrideBytes>::is_contiguous,
+                  "parallel_sort() needs a contiguous view!");
+    parallel_sort(executor, view.as_array_view(), compare);
+}
+
+// ========================================================
+// lower_bound() / upper_bound():
+// ========================================================
+
+//
+// Binary searches over a view sorted by compare, returning an index
+// rather than an iterator so they work the same on strided views.
+// lower_bound() is the first item not less than value, upper_bound()
+// the first item greater than value; view.size() if there's none.
+//
+template<typename View, typename U, typename Compare>
+std::size_t lower_bound(const View & view, const U & value, Compare compare)
+{
+    std::size_t first = 0;
+    std::size_t count = view.size();
+    while (count > 0)
+    {
+        const std::size_t half = count / 2;
+        if (compare(view[first + half], value))
+        {
+            first += half + 1;
+            count -= half + 1;
+        }
+        else
+        {
+            count = half;
+        }
+    }
+    return first;
+}
+
+template<typename View, typename U>
+std::size_t lower_bound(const View & view, const U & value)
+{
+    return lower_bound(view, value, [](const typename View::value_type & item, const U & v) { return item < v; });
+}
+
+template<typename View, typename U, typename Compare>
+std::size_t upper_bound(const View & view, const U & value, Compare compare)
+{
+    std::size_t first = 0;
+    std::size_t count = view.size();
+    while (count > 0)
+    {
+        const std::size_t half = count / 2;
+        if (!compare(value, view[first + half]))
+        {
+            first += half + 1;
+            count -= half + 1;
+        }
+        else
+        {
+            count = half;
+        }
+    }
+    return first;
+}
+
+template<typename View, typename U>
+std::size_t upper_bound(const View & view, const U & value)
+{
+    return upper_bound(view, value, [](const U & v, const typename View::value_type & item) { return v < item; });
+}
+
+#endif // ARRAY_VIEW_ALGORITHMS_HPP
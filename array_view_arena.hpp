@@ -0,0 +1,631 @@
+// ================================================================================================
+// -*- C++ -*-
+// File: array_view_arena.hpp
+// Author: Guilherme R. Lampert
+// Created on: 14/10/26
+//
+// About:
+//  Monotonic (bump pointer) arena allocator handing out array_views, plus
+//  arena_array<T>, a growable array living in an arena. Everything in the
+//  arena is released at once with reset(), e.g. at the end of a frame or
+//  request, and the memory blocks are reused for the next one.
+//
+// License:
+//  This software is in the public domain. Where that dedication is not recognized,
+//  you are granted a perpetual, irrevocable license to copy, distribute, and modify
+//  this file as you see fit. Source code is provided "as is", without warranty of any
+//  kind, express or implied. No attribution is required, but a mention about the author
+//  is appreciated.
+// ================================================================================================
+
+#ifndef ARRAY_VIEW_ARENA_HPP
+#define ARRAY_VIEW_ARENA_HPP
+
+#include "array_view.hpp"
+
+#ifndef ARRAY_VIEW_NO_STD_INCLUDES
+    #include <new>
+    #include <memory>
+#endif // ARRAY_VIEW_NO_STD_INCLUDES
+
+// Byte written over the arena's memory by reset() in debug builds,
+// so reads through views that outlived the reset stand out.
+#ifndef ARRAY_VIEW_ARENA_POISON_BYTE
+    #define ARRAY_VIEW_ARENA_POISON_BYTE 0xDD
+#endif // ARRAY_VIEW_ARENA_POISON_BYTE
+
+template<typename T> class arena_array;
+
+// ========================================================
+// class arena:
+// ========================================================
+
+//
+// Allocations are carved from a list of blocks by bumping a pointer;
+// there is no per-allocation free. reset() rewinds to the first block
+// and bumps the generation number, invalidating everything allocated
+// so far. Blocks are kept and reused, so an arena that has warmed up
+// does no heap allocation at all.
+//
+// Only trivially destructible types can be allocated, since reset()
+// doesn't run destructors. Not thread safe; use one arena per thread
+// or per request.
+//
+// In debug builds (ARRAY_VIEW_DEBUG_CHECKS), reset() fills the released
+// memory with ARRAY_VIEW_ARENA_POISON_BYTE and arena_arrays check their
+// generation on every access. Plain array_views can't carry a generation,
+// so for those the poisoning is what makes a use-after-reset visible.
+//
+class arena final
+{
+public:
+
+    using size_type = std::size_t;
+
+    static constexpr size_type default_block_size = 64 * 1024;
+
+    //
+    // Constructors / destructor:
+    //
+
+    // No memory is allocated until the first allocation.
+    explicit arena(const size_type block_size = default_block_size) noexcept
+        : m_block_size{ block_size }
+    { }
+
+    ~arena()
+    {
+        release();
+    }
+
+    // arena_arrays point back to their arena, so it stays put.
+    arena(const arena &) = delete;
+    arena & operator = (const arena &) = delete;
+
+    //
+    // Allocation:
+    //
+
+    // Uninitialized memory. alignment must be a power of two.
+    void * allocate_bytes(const size_type size_in_bytes, const size_type alignment = alignof(std::max_align_t))
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+        {
+            ARRAY_VIEW_ERROR("arena::allocate_bytes(): alignment must be a power of two!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        // Sizes are compared before forming the aligned pointer, which could
+        // land past m_end when the block is almost full.
+        const auto address        = reinterpret_cast<std::uintptr_t>(m_cursor);
+        const size_type padding   = static_cast<size_type>((0 - address) & static_cast<std::uintptr_t>(alignment - 1));
+        const size_type remaining = static_cast<size_type>(m_end - m_cursor);
+
+        std::uint8_t * ptr;
+        if (m_cursor == nullptr || padding > remaining || size_in_bytes > remaining - padding)
+        {
+            ptr = next_block(size_in_bytes, alignment);
+        }
+        else
+        {
+            ptr = m_cursor + padding;
+        }
+        m_cursor = ptr + size_in_bytes;
+        return ptr;
+    }
+
+    // n default-initialized items, i.e. left uninitialized for scalars and PODs.
+    template<typename T>
+    array_view<T> allocate_view(const size_type item_count)
+    {
+        T * const items = allocate_items<T>(item_count);
+        for (size_type i = 0; i < item_count; ++i)
+        {
+            ::new(static_cast<void *>(items + i)) T;
+        }
+        return { items, item_count };
+    }
+
+    // n copies of value.
+    template<typename T>
+    array_view<T> allocate_view(const size_type item_count, const T & value)
+    {
+        T * const items = allocate_items<T>(item_count);
+        for (size_type i = 0; i < item_count; ++i)
+        {
+            ::new(static_cast<void *>(items + i)) T(value);
+        }
+        return { items, item_count };
+    }
+
+    // A copy of source, e.g. to keep data from a transient buffer until the next reset.
+    template<typename T>
+    array_view<typename std::remove_const<T>::type> allocate_copy(array_view<T> source)
+    {
+        using item_type = typename std::remove_const<T>::type;
+        array_view<item_type> copy{ allocate_items<item_type>(source.size()), source.size() };
+        std::uninitialized_copy(source.begin(), source.end(), copy.data());
+        return copy;
+    }
+
+    template<typename T>
+    arena_array<T> make_array(const size_type initial_capacity = 0)
+    {
+        return arena_array<T>{ *this, initial_capacity };
+    }
+
+    //
+    // Bulk release:
+    //
+
+    // Frees everything allocated so far. Views and arena_arrays into the arena become invalid.
+    void reset() noexcept
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        for (block_header * block = m_first_block; block != nullptr; block = block->next)
+        {
+            std::uint8_t * const block_end = block->data() + block->size;
+            const bool is_current = (m_cursor >= block->data() && m_cursor <= block_end);
+            std::memset(block->data(), ARRAY_VIEW_ARENA_POISON_BYTE,
+                        (is_current ? m_cursor : block_end) - block->data());
+            if (is_current)
+            {
+                break; // Later blocks are unused since the last reset.
+            }
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        m_current_block = m_first_block;
+        m_cursor = (m_first_block != nullptr) ? m_first_block->data() : nullptr;
+        m_end    = (m_first_block != nullptr) ? m_first_block->data() + m_first_block->size : nullptr;
+        ++m_generation;
+    }
+
+    // Also gives the blocks back to the heap.
+    void release() noexcept
+    {
+        block_header * block = m_first_block;
+        while (block != nullptr)
+        {
+            block_header * const next = block->next;
+            ::operator delete(block);
+            block = next;
+        }
+        m_first_block = m_current_block = nullptr;
+        m_cursor = m_end = nullptr;
+        ++m_generation;
+    }
+
+    //
+    // Miscellaneous queries:
+    //
+
+    // Incremented by every reset()/release().
+    std::uint32_t generation() const noexcept
+    {
+        return m_generation;
+    }
+
+    // Total size of the blocks currently owned.
+    size_type bytes_reserved() const noexcept
+    {
+        size_type total = 0;
+        for (const block_header * block = m_first_block; block != nullptr; block = block->next)
+        {
+            total += block->size;
+        }
+        return total;
+    }
+
+    size_type block_size() const noexcept
+    {
+        return m_block_size;
+    }
+
+    bool owns(const void * const ptr) const noexcept
+    {
+        const auto * const byte_ptr = static_cast<const std::uint8_t *>(ptr);
+        for (const block_header * block = m_first_block; block != nullptr; block = block->next)
+        {
+            if (byte_ptr >= block->data() && byte_ptr < block->data() + block->size)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+
+    template<typename> friend class arena_array;
+
+    struct block_header
+    {
+        block_header * next;
+        size_type      size; // Usable bytes after the header.
+
+        std::uint8_t * data() noexcept
+        {
+            return reinterpret_cast<std::uint8_t *>(this) + header_size;
+        }
+        const std::uint8_t * data() const noexcept
+        {
+            return reinterpret_cast<const std::uint8_t *>(this) + header_size;
+        }
+    };
+
+    // Keeps the block data max-aligned, as returned by operator new.
+    static constexpr size_type header_size =
+        (sizeof(block_header) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+    template<typename T>
+    T * allocate_items(const size_type item_count)
+    {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "arena items must be trivially destructible, reset() doesn't run destructors!");
+
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (item_count > static_cast<size_type>(-1) / sizeof(T))
+        {
+            ARRAY_VIEW_ERROR("arena allocation size overflows!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return static_cast<T *>(allocate_bytes(item_count * sizeof(T), alignof(T)));
+    }
+
+    // Grows the most recent allocation in place if there's room. Used by arena_array.
+    bool try_extend(const void * const ptr, const size_type old_size_in_bytes, const size_type new_size_in_bytes) noexcept
+    {
+        const auto * const byte_ptr = static_cast<const std::uint8_t *>(ptr);
+        if (byte_ptr + old_size_in_bytes != m_cursor || new_size_in_bytes > static_cast<size_type>(m_end - byte_ptr))
+        {
+            return false;
+        }
+        m_cursor = const_cast<std::uint8_t *>(byte_ptr) + new_size_in_bytes;
+        return true;
+    }
+
+    static std::uint8_t * align_up(std::uint8_t * const ptr, const size_type alignment) noexcept
+    {
+        const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+        return reinterpret_cast<std::uint8_t *>((address + (alignment - 1)) & ~static_cast<std::uintptr_t>(alignment - 1));
+    }
+
+    // Moves on to the next block that fits, reusing blocks kept by reset()
+    // before allocating a new one. Returns the aligned allocation address.
+    std::uint8_t * next_block(const size_type size_in_bytes, const size_type alignment)
+    {
+        const size_type needed = size_in_bytes + (alignment > alignof(std::max_align_t) ? alignment : 0);
+
+        block_header * block = (m_current_block != nullptr) ? m_current_block->next : m_first_block;
+        if (block == nullptr || block->size < needed)
+        {
+            // None left, or the next one is too small for this allocation: insert a new block here.
+            const size_type size = std::max(m_block_size, needed);
+            auto * const new_block = static_cast<block_header *>(::operator new(header_size + size));
+            new_block->next = block;
+            new_block->size = size;
+
+            if (m_current_block != nullptr)
+            {
+                m_current_block->next = new_block;
+            }
+            else
+            {
+                m_first_block = new_block;
+            }
+            block = new_block;
+        }
+
+        m_current_block = block;
+        m_end = block->data() + block->size;
+        return align_up(block->data(), alignment);
+    }
+
+    block_header * m_first_block   = nullptr;
+    block_header * m_current_block = nullptr;
+    std::uint8_t * m_cursor        = nullptr;
+    std::uint8_t * m_end           = nullptr;
+    size_type      m_block_size;
+    std::uint32_t  m_generation    = 0;
+};
+
+// ========================================================
+// template class arena_array:
+// ========================================================
+
+//
+// Growable array of trivially copyable items stored in an arena, a
+// std::vector stand-in for temporaries. Growing extends the storage in
+// place when it is the arena's latest allocation, otherwise the items
+// are copied to a new allocation and the old one is simply abandoned
+// until reset(). reserve() up front to avoid that waste.
+//
+// Move-only. Converts to array_view like any other container. Iterators
+// are plain pointers, since views made by view() are temporaries. In debug
+// builds every access checks that the arena wasn't reset since the array
+// was created.
+//
+template<typename T>
+class arena_array final
+{
+    static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+                  "arena_array items must be trivially copyable and destructible!");
+
+public:
+
+    using value_type      = T;
+    using size_type       = std::size_t;
+    using pointer         = T *;
+    using const_pointer   = const T *;
+    using reference       = T &;
+    using const_reference = const T &;
+    using iterator        = T *;
+    using const_iterator  = const T *;
+
+    //
+    // Constructors / assignment:
+    //
+
+    // Empty and not attached to an arena; can only be moved into.
+    arena_array() noexcept = default;
+
+    arena_array(arena & owner, const size_type initial_capacity)
+        : m_arena{ &owner }
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        , m_generation{ owner.generation() }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+    {
+        reserve(initial_capacity);
+    }
+
+    arena_array(arena_array && other) noexcept
+    {
+        take(other);
+    }
+
+    arena_array & operator = (arena_array && other) noexcept
+    {
+        if (this != &other)
+        {
+            take(other);
+        }
+        return *this;
+    }
+
+    // Copying would alias the same arena storage.
+    arena_array(const arena_array &) = delete;
+    arena_array & operator = (const arena_array &) = delete;
+
+    //
+    // Size and capacity:
+    //
+
+    void reserve(const size_type new_capacity)
+    {
+        check_live();
+        if (new_capacity <= m_capacity)
+        {
+            return;
+        }
+
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (m_arena == nullptr)
+        {
+            ARRAY_VIEW_ERROR("arena_array isn't attached to an arena!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        if (m_items == nullptr ||
+            !m_arena->try_extend(m_items, m_capacity * sizeof(T), new_capacity * sizeof(T)))
+        {
+            T * const new_items = m_arena->allocate_items<T>(new_capacity);
+            if (m_size != 0)
+            {
+                std::memcpy(new_items, m_items, m_size * sizeof(T));
+            }
+            m_items = new_items;
+        }
+        m_capacity = new_capacity;
+    }
+
+    void resize(const size_type new_size)
+    {
+        resize(new_size, T{});
+    }
+
+    void resize(const size_type new_size, const T & value)
+    {
+        if (new_size > m_capacity)
+        {
+            reserve(grown_capacity(new_size));
+        }
+        check_live();
+        for (size_type i = m_size; i < new_size; ++i)
+        {
+            m_items[i] = value;
+        }
+        m_size = new_size;
+    }
+
+    void push_back(const T & value)
+    {
+        if (m_size == m_capacity)
+        {
+            reserve(grown_capacity(m_size + 1));
+        }
+        check_live();
+        m_items[m_size++] = value;
+    }
+
+    void append(array_view<const T> items)
+    {
+        if (m_size + items.size() > m_capacity)
+        {
+            reserve(grown_capacity(m_size + items.size()));
+        }
+        check_live();
+        if (!items.empty())
+        {
+            std::memcpy(m_items + m_size, items.data(), items.size_bytes());
+        }
+        m_size += items.size();
+    }
+
+    void pop_back()
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (empty())
+        {
+            ARRAY_VIEW_ERROR("arena_array::pop_back(): array is empty!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+        --m_size;
+    }
+
+    // Keeps the capacity.
+    void clear() noexcept
+    {
+        m_size = 0;
+    }
+
+    size_type size()     const noexcept { return m_size;      }
+    size_type capacity() const noexcept { return m_capacity;  }
+    bool      empty()    const noexcept { return m_size == 0; }
+
+    //
+    // Item access:
+    //
+
+    pointer data()
+    {
+        check_live();
+        return m_items;
+    }
+    const_pointer data() const
+    {
+        check_live();
+        return m_items;
+    }
+
+    array_view<T> view()
+    {
+        return { data(), m_size };
+    }
+    array_view<const T> view() const
+    {
+        return { data(), m_size };
+    }
+
+    reference at(const size_type index)
+    {
+        return view().at(index);
+    }
+    const_reference at(const size_type index) const
+    {
+        return view().at(index);
+    }
+
+    reference operator[](const size_type index)
+    {
+        return view()[index];
+    }
+    const_reference operator[](const size_type index) const
+    {
+        return view()[index];
+    }
+
+    reference front()
+    {
+        return view().front();
+    }
+    const_reference front() const
+    {
+        return view().front();
+    }
+
+    reference back()
+    {
+        return view().back();
+    }
+    const_reference back() const
+    {
+        return view().back();
+    }
+
+    //
+    // Iterators:
+    //
+
+    iterator begin()
+    {
+        return data();
+    }
+    const_iterator begin() const
+    {
+        return data();
+    }
+    const_iterator cbegin() const
+    {
+        return data();
+    }
+
+    iterator end()
+    {
+        return data() + m_size;
+    }
+    const_iterator end() const
+    {
+        return data() + m_size;
+    }
+    const_iterator cend() const
+    {
+        return data() + m_size;
+    }
+
+private:
+
+    void check_live() const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (m_arena != nullptr && m_arena->generation() != m_generation)
+        {
+            ARRAY_VIEW_ERROR("arena_array used after its arena was reset!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+    }
+
+    size_type grown_capacity(const size_type min_capacity) const noexcept
+    {
+        return std::max(min_capacity, std::max<size_type>(m_capacity * 2, 8));
+    }
+
+    void take(arena_array & other) noexcept
+    {
+        m_arena    = other.m_arena;
+        m_items    = other.m_items;
+        m_size     = other.m_size;
+        m_capacity = other.m_capacity;
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        m_generation = other.m_generation;
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        other.m_arena    = nullptr;
+        other.m_items    = nullptr;
+        other.m_size     = 0;
+        other.m_capacity = 0;
+    }
+
+    arena *   m_arena    = nullptr;
+    T *       m_items    = nullptr;
+    size_type m_size     = 0;
+    size_type m_capacity = 0;
+
+    #if ARRAY_VIEW_DEBUG_CHECKS
+    std::uint32_t m_generation = 0;
+    #endif // ARRAY_VIEW_DEBUG_CHECKS
+};
+
+#endif // ARRAY_VIEW_ARENA_HPP
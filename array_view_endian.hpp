@@ -0,0 +1,555 @@
+// ================================================================================================
+// -*- C++ -*-
+// File: array_view_endian.hpp
+// Author: Guilherme R. Lampert
+// Created on: 14/10/26
+//
+// About:
+//  packed_field_view<T, Order>, a strided view over a field of packed
+//  records whose items may be misaligned or in a foreign byte order, like
+//  big-endian network headers or file formats. Items are loaded and
+//  stored with memcpy plus a byte swap, so no misaligned T is ever formed,
+//  and are returned by value. decode_to() converts runs of records with
+//  SSSE3 byte shuffles, to parse a received buffer in place.
+//
+// License:
+//  This software is in the public domain. Where that dedication is not recognized,
+//  you are granted a perpetual, irrevocable license to copy, distribute, and modify
+//  this file as you see fit. Source code is provided "as is", without warranty of any
+//  kind, express or implied. No attribution is required, but a mention about the author
+//  is appreciated.
+// ================================================================================================
+
+#ifndef ARRAY_VIEW_ENDIAN_HPP
+#define ARRAY_VIEW_ENDIAN_HPP
+
+#include "array_view.hpp"
+
+// SSSE3 pshufb, for decode_to(). MSVC has no __SSSE3__, but all its AVX targets have SSSE3.
+#ifndef ARRAY_VIEW_NO_SIMD
+    #if defined(__SSSE3__) || (defined(_MSC_VER) && defined(__AVX__))
+        #define ARRAY_VIEW_SSSE3 1
+    #endif // __SSSE3__ || (_MSC_VER && __AVX__)
+#endif // ARRAY_VIEW_NO_SIMD
+
+#ifndef ARRAY_VIEW_NO_STD_INCLUDES
+    #if ARRAY_VIEW_SSSE3
+        #include <tmmintrin.h>
+    #endif // ARRAY_VIEW_SSSE3
+    #if defined(_MSC_VER)
+        #include <stdlib.h> // _byteswap_*
+    #endif // _MSC_VER
+#endif // ARRAY_VIEW_NO_STD_INCLUDES
+
+// ========================================================
+// enum class byte_order:
+// ========================================================
+
+enum class byte_order
+{
+    little,
+    big,
+
+    #if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    native = big
+    #else // Little-endian, or MSVC, which only targets little-endian machines.
+    native = little
+    #endif // __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+};
+
+// ========================================================
+// packed_field_view helpers:
+// ========================================================
+
+namespace array_view_detail
+{
+    template<std::size_t Size> struct unsigned_of_size;
+    template<> struct unsigned_of_size<1> { using type = std::uint8_t;  };
+    template<> struct unsigned_of_size<2> { using type = std::uint16_t; };
+    template<> struct unsigned_of_size<4> { using type = std::uint32_t; };
+    template<> struct unsigned_of_size<8> { using type = std::uint64_t; };
+
+    inline std::uint8_t byte_swap(const std::uint8_t x) noexcept
+    {
+        return x;
+    }
+    inline std::uint16_t byte_swap(const std::uint16_t x) noexcept
+    {
+        #if defined(_MSC_VER) && !defined(__clang__)
+        return _byteswap_ushort(x);
+        #elif defined(__GNUC__) || defined(__clang__)
+        return __builtin_bswap16(x);
+        #else // Compilers usually match this to a bswap anyway.
+        return static_cast<std::uint16_t>((x << 8) | (x >> 8));
+        #endif // _MSC_VER
+    }
+    inline std::uint32_t byte_swap(const std::uint32_t x) noexcept
+    {
+        #if defined(_MSC_VER) && !defined(__clang__)
+        return _byteswap_ulong(x);
+        #elif defined(__GNUC__) || defined(__clang__)
+        return __builtin_bswap32(x);
+        #else // Compilers usually match this to a bswap anyway.
+        return ((x & 0x000000FFu) << 24) | ((x & 0x0000FF00u) << 8) |
+               ((x & 0x00FF0000u) >> 8)  | ((x & 0xFF000000u) >> 24);
+        #endif // _MSC_VER
+    }
+    inline std::uint64_t byte_swap(const std::uint64_t x) noexcept
+    {
+        #if defined(_MSC_VER) && !defined(__clang__)
+        return _byteswap_uint64(x);
+        #elif defined(__GNUC__) || defined(__clang__)
+        return __builtin_bswap64(x);
+        #else // Compilers usually match this to a bswap anyway.
+        return (static_cast<std::uint64_t>(byte_swap(static_cast<std::uint32_t>(x))) << 32) |
+                byte_swap(static_cast<std::uint32_t>(x >> 32));
+        #endif // _MSC_VER
+    }
+
+    // Items are copied through the unsigned integer of the same size,
+    // so floats and enums are swapped as their bit patterns.
+    template<typename T, byte_order Order>
+    inline T load_field(const std::uint8_t * bytes) noexcept
+    {
+        typename unsigned_of_size<sizeof(T)>::type bits;
+        std::memcpy(&bits, bytes, sizeof(bits));
+        if (Order != byte_order::native)
+        {
+            bits = byte_swap(bits);
+        }
+        T value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    template<typename T, byte_order Order>
+    inline void store_field(std::uint8_t * bytes, const T value) noexcept
+    {
+        typename unsigned_of_size<sizeof(T)>::type bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        if (Order != byte_order::native)
+        {
+            bits = byte_swap(bits);
+        }
+        std::memcpy(bytes, &bits, sizeof(bits));
+    }
+
+    #if ARRAY_VIEW_SSSE3
+    //
+    // Decodes the fields of as many records as fit in 16 bytes with one
+    // load and one pshufb, which picks each field's bytes out of its
+    // record and reverses them when swapping. Contiguous fields are the
+    // stride == Size case. Only worth it for two or more records per load.
+    // Loads and stores are full 16 bytes, so the loop stops while both
+    // fit in the count records and count items. Returns the items decoded.
+    //
+    template<std::size_t Size, bool Swap>
+    std::size_t shuffle_decode(const std::uint8_t * records, const std::size_t offset, const std::size_t stride,
+                               const std::size_t count, std::uint8_t * dest) noexcept
+    {
+        const std::size_t per_load = (stride <= 16) ? std::min(16 / stride, 16 / Size) : 0;
+        if (per_load < 2)
+        {
+            return 0;
+        }
+
+        alignas(16) std::uint8_t mask_bytes[16];
+        std::memset(mask_bytes, 0x80, sizeof(mask_bytes)); // High bit set: output byte is zero.
+        for (std::size_t r = 0; r < per_load; ++r)
+        {
+            for (std::size_t b = 0; b < Size; ++b)
+            {
+                mask_bytes[r * Size + b] = static_cast<std::uint8_t>(r * stride + offset + (Swap ? (Size - 1 - b) : b));
+            }
+        }
+        const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i *>(mask_bytes));
+
+        const std::size_t record_bytes = count * stride;
+        const std::size_t dest_bytes   = count * Size;
+        std::size_t i = 0;
+        for (; i + per_load <= count && i * stride + 16 <= record_bytes && i * Size + 16 <= dest_bytes; i += per_load)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(records + i * stride));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dest + i * Size), _mm_shuffle_epi8(v, mask));
+        }
+        return i;
+    }
+    #endif // ARRAY_VIEW_SSSE3
+} // namespace array_view_detail {}
+
+// ========================================================
+// template class packed_field_iterator:
+// ========================================================
+
+//
+// Random access iterator over a packed_field_view. Dereferences
+// to the decoded value, so it can only be read through.
+//
+template<typename T, byte_order Order>
+class packed_field_iterator final
+{
+public:
+
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type        = T;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = void;
+    using reference         = value_type;
+
+    packed_field_iterator() noexcept = default;
+
+    // item points at the field of the first record, not the record.
+    packed_field_iterator(const std::uint8_t * item, const std::size_t stride_bytes) noexcept
+        : m_item{ item }
+        , m_stride{ static_cast<difference_type>(stride_bytes) }
+    { }
+
+    reference operator*() const noexcept { return array_view_detail::load_field<T, Order>(m_item); }
+    reference operator[](const difference_type n) const noexcept { return *(*this + n); }
+
+    packed_field_iterator & operator++() noexcept { m_item += m_stride; return *this; }
+    packed_field_iterator & operator--() noexcept { m_item -= m_stride; return *this; }
+    packed_field_iterator operator++(int) noexcept { packed_field_iterator temp{ *this }; m_item += m_stride; return temp; }
+    packed_field_iterator operator--(int) noexcept { packed_field_iterator temp{ *this }; m_item -= m_stride; return temp; }
+
+    packed_field_iterator & operator += (const difference_type n) noexcept { m_item += n * m_stride; return *this; }
+    packed_field_iterator & operator -= (const difference_type n) noexcept { m_item -= n * m_stride; return *this; }
+    packed_field_iterator operator + (const difference_type n) const noexcept { packed_field_iterator temp{ *this }; return temp += n; }
+    packed_field_iterator operator - (const difference_type n) const noexcept { packed_field_iterator temp{ *this }; return temp -= n; }
+    friend packed_field_iterator operator + (const difference_type n, const packed_field_iterator & iter) noexcept { return iter + n; }
+    difference_type operator - (const packed_field_iterator & other) const noexcept
+    {
+        return (m_stride != 0) ? (m_item - other.m_item) / m_stride : 0;
+    }
+
+    bool operator == (const packed_field_iterator & other) const noexcept { return m_item == other.m_item; }
+    bool operator != (const packed_field_iterator & other) const noexcept { return m_item != other.m_item; }
+    bool operator <  (const packed_field_iterator & other) const noexcept { return m_item <  other.m_item; }
+    bool operator >  (const packed_field_iterator & other) const noexcept { return m_item >  other.m_item; }
+    bool operator <= (const packed_field_iterator & other) const noexcept { return m_item <= other.m_item; }
+    bool operator >= (const packed_field_iterator & other) const noexcept { return m_item >= other.m_item; }
+
+private:
+
+    const std::uint8_t * m_item   = nullptr;
+    difference_type      m_stride = 0;
+};
+
+// ========================================================
+// template class packed_field_view:
+// ========================================================
+
+//
+// View over one field of a sequence of packed records, like
+// strided_array_view, but for fields that may be misaligned or stored
+// in byte order Order. The layout is the same OffsetBytes/StrideBytes
+// pair, static or both dynamic_extent (given to the constructor).
+//
+// T is an arithmetic or enum type of 1, 2, 4 or 8 bytes, const for
+// read-only views. Items are returned by value; mutable views write
+// them with set(). The record bytes need no particular alignment.
+//
+//  // struct { u8 flags; be32 sequence; be16 length; } per 7 byte record:
+//  auto sequences = make_packed_field_view<const std::uint32_t, byte_order::big>(packet, 1, 7);
+//  sequences.decode_to(make_array_view(parsed));
+//
+template
+<
+    typename T,
+    byte_order Order,
+    std::size_t OffsetBytes = dynamic_extent,
+    std::size_t StrideBytes = dynamic_extent
+>
+class packed_field_view final
+    : private array_view_detail::stride_storage<OffsetBytes, StrideBytes>
+{
+    using stride_storage_type = array_view_detail::stride_storage<OffsetBytes, StrideBytes>;
+
+    static_assert((OffsetBytes == dynamic_extent) == (StrideBytes == dynamic_extent),
+                  "OffsetBytes and StrideBytes must be either both static or both dynamic_extent!");
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                  "packed_field_view items must be arithmetic or enum types!");
+    static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8,
+                  "packed_field_view items must be 1, 2, 4 or 8 bytes!");
+    static_assert(StrideBytes == dynamic_extent || OffsetBytes + sizeof(T) <= StrideBytes,
+                  "packed_field_view item doesn't fit in the stride!");
+
+    static constexpr bool is_mutable = !std::is_const<T>::value;
+
+public:
+
+    //
+    // Nested types:
+    //
+
+    using value_type      = typename std::remove_const<T>::type;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using byte_type       = typename std::conditional<is_mutable, std::uint8_t, const std::uint8_t>::type;
+    using byte_ptr_type   = byte_type *;
+    using iterator        = packed_field_iterator<value_type, Order>;
+    using const_iterator  = iterator;
+
+    static constexpr byte_order order = Order;
+
+    //
+    // Constructors / assignment:
+    //
+
+    packed_field_view() noexcept = default;
+
+    // Compile-time layout. A trailing partial record is ignored.
+    template<size_type S = StrideBytes, typename std::enable_if<S != dynamic_extent, int>::type = 0>
+    explicit packed_field_view(array_view<byte_type> bytes) noexcept
+        : m_pointer{ bytes.data() }
+        , m_size_in_items{ bytes.size() / StrideBytes }
+    { }
+
+    // Runtime layout. A trailing partial record is ignored.
+    template<size_type S = StrideBytes, typename std::enable_if<S == dynamic_extent, int>::type = 0>
+    packed_field_view(array_view<byte_type> bytes, const size_type offset_in_bytes, const size_type stride_in_bytes) ARRAY_VIEW_UNCHECKED_NOEXCEPT
+        : stride_storage_type{ offset_in_bytes, stride_in_bytes }
+        , m_pointer{ bytes.data() }
+        , m_size_in_items{ (stride_in_bytes != 0) ? bytes.size() / stride_in_bytes : 0 }
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (stride_in_bytes == 0)
+        {
+            ARRAY_VIEW_ERROR("packed_field_view stride is zero!");
+        }
+        if (offset_in_bytes + sizeof(value_type) > stride_in_bytes)
+        {
+            ARRAY_VIEW_ERROR("packed_field_view item doesn't fit in the stride!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+    }
+
+    // Mutable to const conversion, and any layout to the runtime layout.
+    template
+    <
+        typename OtherT,
+        std::size_t OtherOffsetBytes,
+        std::size_t OtherStrideBytes,
+        typename std::enable_if<std::is_same<const OtherT, const value_type>::value &&
+                                (is_mutable <= std::is_same<OtherT, value_type>::value) &&
+                                (StrideBytes == dynamic_extent ||
+                                 (OffsetBytes == OtherOffsetBytes && StrideBytes == OtherStrideBytes)), int>::type = 0
+    >
+    packed_field_view(const packed_field_view<OtherT, Order, OtherOffsetBytes, OtherStrideBytes> & other) noexcept
+        : stride_storage_type{ other.offset_bytes(), other.stride_bytes() }
+        , m_pointer{ other.data() }
+        , m_size_in_items{ other.size() }
+    { }
+
+    //
+    // Data access:
+    //
+
+    value_type operator[](const size_type index) const
+    {
+        check_index(index);
+        return array_view_detail::load_field<value_type, Order>(get_item_raw_ptr(index));
+    }
+
+    value_type at(const size_type index) const
+    {
+        // at() always validates the bounds.
+        if (data() == nullptr)
+        {
+            ARRAY_VIEW_ERROR("packed_field_view: null pointer!");
+        }
+        if (index >= size())
+        {
+            ARRAY_VIEW_ERROR("packed_field_view::at(): index is out-of-bounds!");
+        }
+        return array_view_detail::load_field<value_type, Order>(get_item_raw_ptr(index));
+    }
+
+    value_type front() const
+    {
+        return operator[](0);
+    }
+    value_type back() const
+    {
+        return operator[](size() - 1);
+    }
+
+    // Stores value in byte order Order.
+    template<bool M = is_mutable, typename std::enable_if<M, int>::type = 0>
+    void set(const size_type index, const value_type value) const
+    {
+        check_index(index);
+        array_view_detail::store_field<value_type, Order>(get_item_raw_ptr(index), value);
+    }
+
+    // Never checked. Points at the field bytes, which may be misaligned for T.
+    byte_ptr_type get_item_raw_ptr(const size_type index) const noexcept
+    {
+        return m_pointer + (index * stride_bytes()) + offset_bytes();
+    }
+
+    //
+    // Bulk conversion to and from native order contiguous arrays:
+    //
+
+    // Decodes all size() items into dest, which must be at least as big.
+    void decode_to(array_view<value_type> dest) const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (dest.size() < size())
+        {
+            ARRAY_VIEW_ERROR("packed_field_view::decode_to(): destination is too small!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        if (empty())
+        {
+            return;
+        }
+
+        size_type done = 0;
+        #if ARRAY_VIEW_SSSE3
+        done = array_view_detail::shuffle_decode<sizeof(value_type), Order != byte_order::native>(
+            m_pointer, offset_bytes(), stride_bytes(), size(), reinterpret_cast<std::uint8_t *>(dest.data()));
+        #endif // ARRAY_VIEW_SSSE3
+
+        value_type * const out = dest.data();
+        for (size_type i = done; i < size(); ++i)
+        {
+            out[i] = array_view_detail::load_field<value_type, Order>(get_item_raw_ptr(i));
+        }
+    }
+
+    // Encodes source into the first source.size() items, in byte order Order.
+    template<bool M = is_mutable, typename std::enable_if<M, int>::type = 0>
+    void encode_from(array_view<const value_type> source) const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (source.size() > size())
+        {
+            ARRAY_VIEW_ERROR("packed_field_view::encode_from(): source is bigger than the view!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        const value_type * const in = source.data();
+        for (size_type i = 0; i < source.size(); ++i)
+        {
+            array_view_detail::store_field<value_type, Order>(get_item_raw_ptr(i), in[i]);
+        }
+    }
+
+    //
+    // Miscellaneous queries:
+    //
+
+    byte_ptr_type data() const noexcept
+    {
+        return m_pointer;
+    }
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+    size_type size() const noexcept
+    {
+        return m_size_in_items;
+    }
+    size_type size_bytes() const noexcept
+    {
+        return size() * stride_bytes();
+    }
+
+    // Static constexpr for compile-time layouts, plain members otherwise.
+    using stride_storage_type::offset_bytes;
+    using stride_storage_type::stride_bytes;
+
+    //
+    // Iterators:
+    //
+
+    iterator begin() const noexcept
+    {
+        return iterator{ m_pointer + offset_bytes(), stride_bytes() };
+    }
+    iterator end() const noexcept
+    {
+        return iterator{ m_pointer + size_bytes() + offset_bytes(), stride_bytes() };
+    }
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+private:
+
+    void check_index(const size_type index) const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (data() == nullptr)
+        {
+            ARRAY_VIEW_ERROR("packed_field_view: null pointer!");
+        }
+        if (index >= size())
+        {
+            ARRAY_VIEW_ERROR("packed_field_view: index is out-of-bounds!");
+        }
+        #else // !ARRAY_VIEW_DEBUG_CHECKS
+        (void)index;
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+    }
+
+    byte_ptr_type m_pointer       = nullptr;
+    size_type     m_size_in_items = 0;
+};
+
+template<typename T, byte_order Order, std::size_t OffsetBytes, std::size_t StrideBytes>
+constexpr byte_order packed_field_view<T, Order, OffsetBytes, StrideBytes>::order;
+
+// Field of records stored most significant byte first (network order).
+template<typename T, std::size_t OffsetBytes = dynamic_extent, std::size_t StrideBytes = dynamic_extent>
+using big_endian_field_view = packed_field_view<T, byte_order::big, OffsetBytes, StrideBytes>;
+
+// Field of records stored least significant byte first.
+template<typename T, std::size_t OffsetBytes = dynamic_extent, std::size_t StrideBytes = dynamic_extent>
+using little_endian_field_view = packed_field_view<T, byte_order::little, OffsetBytes, StrideBytes>;
+
+// ========================================================
+// make_packed_field_view() helpers:
+// ========================================================
+
+//
+// From a view of any byte type (char, unsigned char, std::uint8_t...).
+// T must be const if the bytes are.
+//
+template<typename T, byte_order Order, typename ByteType, std::size_t Extent>
+packed_field_view<T, Order> make_packed_field_view(array_view<ByteType, Extent> bytes,
+                                                   const std::size_t offset_in_bytes,
+                                                   const std::size_t stride_in_bytes) ARRAY_VIEW_UNCHECKED_NOEXCEPT
+{
+    static_assert(sizeof(ByteType) == 1, "make_packed_field_view() needs a view of bytes!");
+    static_assert(std::is_const<T>::value || !std::is_const<ByteType>::value,
+                  "make_packed_field_view() can't cast away const!");
+
+    using byte_type = typename packed_field_view<T, Order>::byte_type;
+    return packed_field_view<T, Order>{ array_view<byte_type>{ reinterpret_cast<byte_type *>(bytes.data()), bytes.size() },
+                                        offset_in_bytes, stride_in_bytes };
+}
+
+// Same with the layout fixed at compile-time.
+template<typename T, byte_order Order, std::size_t OffsetBytes, std::size_t StrideBytes, typename ByteType, std::size_t Extent>
+packed_field_view<T, Order, OffsetBytes, StrideBytes> make_packed_field_view(array_view<ByteType, Extent> bytes) noexcept
+{
+    static_assert(sizeof(ByteType) == 1, "make_packed_field_view() needs a view of bytes!");
+    static_assert(std::is_const<T>::value || !std::is_const<ByteType>::value,
+                  "make_packed_field_view() can't cast away const!");
+
+    using byte_type = typename packed_field_view<T, Order, OffsetBytes, StrideBytes>::byte_type;
+    return packed_field_view<T, Order, OffsetBytes, StrideBytes>{
+        array_view<byte_type>{ reinterpret_cast<byte_type *>(bytes.data()), bytes.size() } };
+}
+
+#endif // ARRAY_VIEW_ENDIAN_HPP
@@ -0,0 +1,345 @@
+// ================================================================================================
+// -*- C++ -*-
+// File: array_view_iovec.hpp
+// Author: Guilherme R. Lampert
+// Created on: 14/10/26
+//
+// About:
+//  Scatter/gather buffer lists built from array_views, stored directly
+//  as the platform's native descriptors (struct iovec on POSIX, WSABUF
+//  on Windows). A response made of many fragments can go to writev(),
+//  readv(), io_uring or WSASend() as is, without first concatenating it
+//  into one buffer. consume() advances past bytes already transferred,
+//  across fragment boundaries, for partial writes.
+//
+// License:
+//  This software is in the public domain. Where that dedication is not recognized,
+//  you are granted a perpetual, irrevocable license to copy, distribute, and modify
+//  this file as you see fit. Source code is provided "as is", without warranty of any
+//  kind, express or implied. No attribution is required, but a mention about the author
+//  is appreciated.
+// ================================================================================================
+
+#ifndef ARRAY_VIEW_IOVEC_HPP
+#define ARRAY_VIEW_IOVEC_HPP
+
+#include "array_view.hpp"
+
+#ifndef ARRAY_VIEW_NO_STD_INCLUDES
+    #if defined(_WIN32)
+        #ifndef WIN32_LEAN_AND_MEAN
+            #define WIN32_LEAN_AND_MEAN 1
+        #endif // WIN32_LEAN_AND_MEAN
+        #ifndef NOMINMAX
+            #define NOMINMAX 1
+        #endif // NOMINMAX
+        #include <winsock2.h>
+    #else // POSIX
+        #include <sys/uio.h>
+    #endif // _WIN32
+    #include <initializer_list>
+#endif // ARRAY_VIEW_NO_STD_INCLUDES
+
+// ========================================================
+// Native buffer descriptors:
+// ========================================================
+
+#if defined(_WIN32)
+using native_io_buffer = WSABUF;
+#else // POSIX
+using native_io_buffer = struct iovec;
+#endif // _WIN32
+
+namespace array_view_detail
+{
+    #if defined(_WIN32)
+    inline native_io_buffer make_native_io_buffer(const void * data, const std::size_t size_in_bytes)
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (size_in_bytes > static_cast<std::size_t>(static_cast<ULONG>(-1)))
+        {
+            ARRAY_VIEW_ERROR("WSABUF can't hold more than 4GB per buffer!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        native_io_buffer buffer;
+        buffer.buf = static_cast<CHAR *>(const_cast<void *>(data));
+        buffer.len = static_cast<ULONG>(size_in_bytes);
+        return buffer;
+    }
+    inline std::uint8_t * native_io_buffer_data(const native_io_buffer & buffer) noexcept
+    {
+        return reinterpret_cast<std::uint8_t *>(buffer.buf);
+    }
+    inline std::size_t native_io_buffer_size(const native_io_buffer & buffer) noexcept
+    {
+        return buffer.len;
+    }
+    #else // POSIX
+    inline native_io_buffer make_native_io_buffer(const void * data, const std::size_t size_in_bytes) noexcept
+    {
+        native_io_buffer buffer;
+        buffer.iov_base = const_cast<void *>(data);
+        buffer.iov_len  = size_in_bytes;
+        return buffer;
+    }
+    inline std::uint8_t * native_io_buffer_data(const native_io_buffer & buffer) noexcept
+    {
+        return static_cast<std::uint8_t *>(buffer.iov_base);
+    }
+    inline std::size_t native_io_buffer_size(const native_io_buffer & buffer) noexcept
+    {
+        return buffer.iov_len;
+    }
+    #endif // _WIN32
+} // namespace array_view_detail {}
+
+// ========================================================
+// template class buffer_sequence:
+// ========================================================
+
+//
+// Fixed-capacity list of up to MaxBuffers byte ranges, kept as a
+// native_io_buffer array so it can be passed to the OS calls directly.
+// Nothing is allocated and nothing is copied, the buffers keep pointing
+// at the memory they were made from, which must outlive the sequence.
+//
+// ByteType is const std::uint8_t for gather writes (const_buffer_sequence)
+// or std::uint8_t for scatter reads (mutable_buffer_sequence). Any
+// trivially copyable array_view can be appended, as its bytes.
+//
+// Partial write loop:
+//
+//  const_buffer_sequence<> response;
+//  response.push_back(header);
+//  response.push_back(cached_body);
+//  response.push_back(trailer);
+//  while (!response.empty())
+//  {
+//      const ssize_t written = ::writev(fd, response.data(), response.native_count());
+//      if (written < 0) { ...handle error... }
+//      response.consume(static_cast<std::size_t>(written));
+//  }
+//
+template
+<
+    typename ByteType,
+    std::size_t MaxBuffers = 16
+>
+class buffer_sequence final
+{
+    static_assert(std::is_same<typename std::remove_const<ByteType>::type, std::uint8_t>::value,
+                  "buffer_sequence ByteType must be std::uint8_t or const std::uint8_t!");
+    static_assert(MaxBuffers > 0, "buffer_sequence needs room for at least one buffer!");
+
+public:
+
+    using byte_type  = ByteType;
+    using size_type  = std::size_t;
+    using value_type = array_view<byte_type>;
+
+    static constexpr size_type max_buffers = MaxBuffers;
+
+    //
+    // Constructors / assignment:
+    //
+
+    buffer_sequence() noexcept = default;
+
+    // Copying copies the descriptors, both copies refer to the same memory.
+    buffer_sequence(const buffer_sequence & other) noexcept
+    {
+        copy_from(other);
+    }
+    buffer_sequence & operator = (const buffer_sequence & other) noexcept
+    {
+        if (this != &other)
+        {
+            copy_from(other);
+        }
+        return *this;
+    }
+
+    //
+    // Building the sequence:
+    //
+
+    // Appends the bytes of a view. Empty views are skipped. The sequence
+    // must not be full; check full() first if the fragment count varies.
+    template<typename T, std::size_t Extent>
+    void push_back(array_view<T, Extent> view)
+    {
+        static_assert(std::is_trivially_copyable<typename std::remove_const<T>::type>::value,
+                      "buffer_sequence can only hold views of trivially copyable types!");
+        static_assert(std::is_const<byte_type>::value || !std::is_const<T>::value,
+                      "mutable_buffer_sequence needs mutable views!");
+
+        if (view.empty())
+        {
+            return;
+        }
+
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (full())
+        {
+            ARRAY_VIEW_ERROR("buffer_sequence::push_back(): sequence is full!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        m_buffers[m_last++] = array_view_detail::make_native_io_buffer(view.data(), view.size_bytes());
+        m_total_bytes += view.size_bytes();
+    }
+
+    // Same as push_back() for each view in the list.
+    template<typename T>
+    void append(std::initializer_list<array_view<T>> views)
+    {
+        for (const array_view<T> & view : views)
+        {
+            push_back(view);
+        }
+    }
+
+    // Drops all buffers.
+    void clear() noexcept
+    {
+        m_first = m_last = 0;
+        m_total_bytes = 0;
+    }
+
+    //
+    // Advancing after partial transfers:
+    //
+
+    // Removes the first byte_count bytes, e.g. what writev() reported as
+    // written. Buffers consumed fully are dropped and the first remaining
+    // one is trimmed. byte_count must not exceed total_bytes().
+    void consume(size_type byte_count)
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (byte_count > m_total_bytes)
+        {
+            ARRAY_VIEW_ERROR("buffer_sequence::consume(): more bytes than the sequence holds!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        m_total_bytes -= byte_count;
+        while (byte_count != 0)
+        {
+            native_io_buffer & front_buffer = m_buffers[m_first];
+            const size_type front_size = array_view_detail::native_io_buffer_size(front_buffer);
+            if (byte_count < front_size)
+            {
+                front_buffer = array_view_detail::make_native_io_buffer(
+                    array_view_detail::native_io_buffer_data(front_buffer) + byte_count, front_size - byte_count);
+                break;
+            }
+            byte_count -= front_size;
+            ++m_first;
+        }
+
+        // Reclaim the dropped slots once everything has been consumed.
+        if (m_first == m_last)
+        {
+            m_first = m_last = 0;
+        }
+    }
+
+    //
+    // Native descriptors, for writev()/readv()/io_uring/WSASend()/WSARecv():
+    //
+
+    native_io_buffer * data() noexcept
+    {
+        return m_buffers + m_first;
+    }
+    const native_io_buffer * data() const noexcept
+    {
+        return m_buffers + m_first;
+    }
+
+    // size() as the int the OS calls take for the buffer count.
+    int native_count() const noexcept
+    {
+        return static_cast<int>(size());
+    }
+
+    //
+    // Queries:
+    //
+
+    // Buffer at index as an array_view.
+    value_type operator[](const size_type index) const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (index >= size())
+        {
+            ARRAY_VIEW_ERROR("buffer_sequence::operator[]: index is out-of-bounds!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        const native_io_buffer & buffer = m_buffers[m_first + index];
+        return value_type{ array_view_detail::native_io_buffer_data(buffer),
+                           array_view_detail::native_io_buffer_size(buffer) };
+    }
+
+    // Number of buffers left.
+    size_type size() const noexcept
+    {
+        return m_last - m_first;
+    }
+
+    // Bytes left in all buffers.
+    size_type total_bytes() const noexcept
+    {
+        return m_total_bytes;
+    }
+
+    bool empty() const noexcept
+    {
+        return m_first == m_last;
+    }
+
+    // True if push_back() has no free slot left. Slots of buffers dropped
+    // by consume() are only reused after the sequence is fully consumed.
+    bool full() const noexcept
+    {
+        return m_last == MaxBuffers;
+    }
+
+    static constexpr size_type capacity() noexcept
+    {
+        return MaxBuffers;
+    }
+
+private:
+
+    void copy_from(const buffer_sequence & other) noexcept
+    {
+        m_first = 0;
+        m_last  = other.size();
+        m_total_bytes = other.m_total_bytes;
+        for (size_type i = 0; i < m_last; ++i)
+        {
+            m_buffers[i] = other.m_buffers[other.m_first + i];
+        }
+    }
+
+    native_io_buffer m_buffers[MaxBuffers];
+    size_type m_first       = 0; // First buffer not yet consumed.
+    size_type m_last        = 0; // One past the last buffer appended.
+    size_type m_total_bytes = 0;
+};
+
+template<typename ByteType, std::size_t MaxBuffers>
+constexpr std::size_t buffer_sequence<ByteType, MaxBuffers>::max_buffers;
+
+// For gather writes (writev, WSASend, IORING_OP_WRITEV).
+template<std::size_t MaxBuffers = 16>
+using const_buffer_sequence = buffer_sequence<const std::uint8_t, MaxBuffers>;
+
+// For scatter reads (readv, WSARecv, IORING_OP_READV).
+template<std::size_t MaxBuffers = 16>
+using mutable_buffer_sequence = buffer_sequence<std::uint8_t, MaxBuffers>;
+
+#endif // ARRAY_VIEW_IOVEC_HPP
@@ -0,0 +1,444 @@
+
+// ================================================================================================
+// -*- C++ -*-
+// File: array_view_mapped_file.hpp
+// Author: Guilherme R. Lampert
+// Created on: 14/10/26
+//
+// About:
+//  Read-only memory-mapped files handing out array_view and
+//  strided_array_view windows over the mapping, so large binary
+//  tables can be used in place without reading them into memory.
+//  Uses mmap on POSIX systems and MapViewOfFile on Windows.
+//
+// License:
+//  This software is in the public domain. Where that dedication is not recognized,
+//  you are granted a perpetual, irrevocable license to copy, distribute, and modify
+//  this file as you see fit. Source code is provided "as is", without warranty of any
+//  kind, express or implied. No attribution is required, but a mention about the author
+//  is appreciated.
+// ================================================================================================
+
+#ifndef ARRAY_VIEW_MAPPED_FILE_HPP
+#define ARRAY_VIEW_MAPPED_FILE_HPP
+
+#include "array_view.hpp"
+
+#ifndef ARRAY_VIEW_NO_STD_INCLUDES
+    #if defined(_WIN32)
+        #ifndef WIN32_LEAN_AND_MEAN
+            #define WIN32_LEAN_AND_MEAN 1
+        #endif // WIN32_LEAN_AND_MEAN
+        #ifndef NOMINMAX
+            #define NOMINMAX 1
+        #endif // NOMINMAX
+        #include <windows.h>
+    #else // POSIX
+        #include <fcntl.h>
+        #include <unistd.h>
+        #include <sys/mman.h>
+        #include <sys/stat.h>
+    #endif // _WIN32
+#endif // ARRAY_VIEW_NO_STD_INCLUDES
+
+// ========================================================
+// class mapped_file:
+// ========================================================
+
+//
+// Access pattern hints forwarded to madvise(). On Windows only
+// will_need does something (PrefetchVirtualMemory), the rest are
+// accepted and ignored.
+//
+enum class mapped_file_advice
+{
+    normal,
+    sequential,
+    random,
+    will_need,
+    dont_need
+};
+
+//
+// RAII read-only mapping of a whole file. Move-only.
+//
+// Opening can fail for ordinary reasons (missing file, permissions),
+// so open() reports it by returning false instead of ARRAY_VIEW_ERROR.
+// Windows handed out by view()/strided_view() follow the usual
+// array_view rules: bounds and alignment are verified with
+// ARRAY_VIEW_DEBUG_CHECKS only, and the views dangle once the
+// mapped_file is closed or destroyed.
+//
+class mapped_file final
+{
+public:
+
+    //
+    // Flags for open():
+    //
+
+    // Ask for transparent huge pages on the mapping (Linux MADV_HUGEPAGE,
+    // only honoured by kernels/filesystems that support it for files).
+    static constexpr unsigned huge_pages = 1 << 0;
+
+    // Pre-fault the whole mapping on open (Linux MAP_POPULATE).
+    static constexpr unsigned populate = 1 << 1;
+
+    //
+    // Constructors / assignment:
+    //
+
+    mapped_file() noexcept = default;
+
+    explicit mapped_file(const char * const path, const unsigned flags = 0)
+    {
+        open(path, flags);
+    }
+
+    ~mapped_file()
+    {
+        close();
+    }
+
+    mapped_file(mapped_file && other) noexcept
+    {
+        take(other);
+    }
+
+    mapped_file & operator = (mapped_file && other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            take(other);
+        }
+        return *this;
+    }
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file & operator = (const mapped_file &) = delete;
+
+    //
+    // Open / close:
+    //
+
+    // Maps the file at path. Any previous mapping is closed first.
+    // An empty file opens successfully with a null data() and zero size.
+    bool open(const char * const path, const unsigned flags = 0)
+    {
+        close();
+
+        #if defined(_WIN32)
+        m_file_handle = ::CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_file_handle == INVALID_HANDLE_VALUE)
+        {
+            m_file_handle = nullptr;
+            return false;
+        }
+
+        LARGE_INTEGER file_size;
+        if (!::GetFileSizeEx(m_file_handle, &file_size))
+        {
+            close();
+            return false;
+        }
+
+        m_is_open = true;
+        if (file_size.QuadPart == 0)
+        {
+            return true;
+        }
+
+        m_mapping_handle = ::CreateFileMappingA(m_file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping_handle == nullptr)
+        {
+            close();
+            return false;
+        }
+
+        void * const address = ::MapViewOfFile(m_mapping_handle, FILE_MAP_READ, 0, 0, 0);
+        if (address == nullptr)
+        {
+            close();
+            return false;
+        }
+
+        m_data = static_cast<const std::uint8_t *>(address);
+        m_size_in_bytes = static_cast<std::size_t>(file_size.QuadPart);
+        (void)flags; // Large pages are not available for file-backed sections.
+        #else // POSIX
+        const int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat file_info;
+        if (::fstat(fd, &file_info) != 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        m_is_open = true;
+        if (file_info.st_size == 0)
+        {
+            ::close(fd);
+            return true;
+        }
+
+        int map_flags = MAP_PRIVATE;
+        #if defined(MAP_POPULATE)
+        if (flags & populate)
+        {
+            map_flags |= MAP_POPULATE;
+        }
+        #endif // MAP_POPULATE
+
+        const std::size_t length = static_cast<std::size_t>(file_info.st_size);
+        void * const address = ::mmap(nullptr, length, PROT_READ, map_flags, fd, 0);
+
+        // The mapping keeps its own reference to the file.
+        ::close(fd);
+
+        if (address == MAP_FAILED)
+        {
+            m_is_open = false;
+            return false;
+        }
+
+        m_data = static_cast<const std::uint8_t *>(address);
+        m_size_in_bytes = length;
+
+        #if defined(MADV_HUGEPAGE)
+        if (flags & huge_pages)
+        {
+            ::madvise(address, length, MADV_HUGEPAGE); // Only a hint, failure is fine.
+        }
+        #endif // MADV_HUGEPAGE
+        #endif // _WIN32
+
+        return true;
+    }
+
+    void close() noexcept
+    {
+        #if defined(_WIN32)
+        if (m_data != nullptr)
+        {
+            ::UnmapViewOfFile(m_data);
+        }
+        if (m_mapping_handle != nullptr)
+        {
+            ::CloseHandle(m_mapping_handle);
+        }
+        if (m_file_handle != nullptr)
+        {
+            ::CloseHandle(m_file_handle);
+        }
+        m_mapping_handle = nullptr;
+        m_file_handle = nullptr;
+        #else // POSIX
+        if (m_data != nullptr)
+        {
+            ::munmap(const_cast<std::uint8_t *>(m_data), m_size_in_bytes);
+        }
+        #endif // _WIN32
+
+        m_data = nullptr;
+        m_size_in_bytes = 0;
+        m_is_open = false;
+    }
+
+    bool is_open() const noexcept
+    {
+        return m_is_open;
+    }
+
+    //
+    // Access pattern hints:
+    //
+
+    // Applies the hint to [offset_bytes, offset_bytes + length_bytes), or to
+    // the rest of the file if length_bytes is dynamic_extent. The offset is
+    // rounded down to a page boundary. Returns false if the OS rejected it.
+    bool advise(const mapped_file_advice advice, std::size_t offset_bytes = 0,
+                std::size_t length_bytes = dynamic_extent) const noexcept
+    {
+        if (m_data == nullptr || offset_bytes >= m_size_in_bytes)
+        {
+            return false;
+        }
+        if (length_bytes > m_size_in_bytes - offset_bytes)
+        {
+            length_bytes = m_size_in_bytes - offset_bytes;
+        }
+
+        const std::size_t page = page_size();
+        const std::size_t misalignment = offset_bytes % page;
+        offset_bytes -= misalignment;
+        length_bytes += misalignment;
+
+        #if defined(_WIN32)
+        if (advice != mapped_file_advice::will_need)
+        {
+            return true;
+        }
+        #if defined(_WIN32_WINNT) && (_WIN32_WINNT >= 0x0602)
+        WIN32_MEMORY_RANGE_ENTRY range;
+        range.VirtualAddress = const_cast<std::uint8_t *>(m_data + offset_bytes);
+        range.NumberOfBytes  = length_bytes;
+        return ::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &range, 0) != FALSE;
+        #else // Older than Windows 8
+        return true;
+        #endif // _WIN32_WINNT >= 0x0602
+        #else // POSIX
+        int native_advice = MADV_NORMAL;
+        switch (advice)
+        {
+        case mapped_file_advice::sequential : native_advice = MADV_SEQUENTIAL; break;
+        case mapped_file_advice::random     : native_advice = MADV_RANDOM;     break;
+        case mapped_file_advice::will_need  : native_advice = MADV_WILLNEED;   break;
+        case mapped_file_advice::dont_need  : native_advice = MADV_DONTNEED;   break;
+        default : break;
+        }
+        return ::madvise(const_cast<std::uint8_t *>(m_data + offset_bytes), length_bytes, native_advice) == 0;
+        #endif // _WIN32
+    }
+
+    //
+    // Views into the mapping:
+    //
+
+    array_view<const std::uint8_t> bytes() const noexcept
+    {
+        return { m_data, m_size_in_bytes };
+    }
+
+    // item_count items of T starting at offset_bytes. A count of
+    // dynamic_extent takes as many whole items as fit in the file.
+    template<typename T>
+    array_view<const T> view(const std::size_t offset_bytes = 0, const std::size_t item_count = dynamic_extent) const
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be viewed in a mapped file!");
+
+        const std::size_t count = window_size(offset_bytes, item_count, sizeof(T));
+
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (count != 0 && reinterpret_cast<std::uintptr_t>(m_data + offset_bytes) % alignof(T) != 0)
+        {
+            ARRAY_VIEW_ERROR("mapped_file::view(): offset is misaligned for the item type!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return { (count != 0) ? reinterpret_cast<const T *>(m_data + offset_bytes) : nullptr, count };
+    }
+
+    // Compile-time layout strided window. offset_bytes is where the
+    // first structure begins in the file, item_count in structures.
+    template<typename T, std::size_t OffsetBytes, std::size_t StrideBytes>
+    strided_array_view<const T, OffsetBytes, StrideBytes> strided_view(const std::size_t offset_bytes = 0,
+                                                                       const std::size_t item_count = dynamic_extent) const
+    {
+        const std::size_t count = window_size(offset_bytes, item_count, StrideBytes);
+        return { (count != 0) ? m_data + offset_bytes : nullptr, count * StrideBytes };
+    }
+
+    // Runtime layout strided window.
+    template<typename T>
+    dynamic_strided_array_view<const T> strided_view(const std::size_t member_offset_bytes, const std::size_t stride_bytes,
+                                                     const std::size_t offset_bytes = 0,
+                                                     const std::size_t item_count = dynamic_extent) const
+    {
+        const std::size_t count = window_size(offset_bytes, item_count, stride_bytes);
+        return { (count != 0) ? m_data + offset_bytes : nullptr, count * stride_bytes, member_offset_bytes, stride_bytes };
+    }
+
+    //
+    // Miscellaneous queries:
+    //
+
+    const std::uint8_t * data() const noexcept
+    {
+        return m_data;
+    }
+    std::size_t size_bytes() const noexcept
+    {
+        return m_size_in_bytes;
+    }
+    bool empty() const noexcept
+    {
+        return m_size_in_bytes == 0;
+    }
+
+    static std::size_t page_size() noexcept
+    {
+        #if defined(_WIN32)
+        SYSTEM_INFO info;
+        ::GetSystemInfo(&info);
+        return static_cast<std::size_t>(info.dwPageSize);
+        #else // POSIX
+        return static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        #endif // _WIN32
+    }
+
+    //
+    // Non-throwing swap() overload for mapped_file:
+    //
+
+    friend void swap(mapped_file & lhs, mapped_file & rhs) noexcept
+    {
+        mapped_file temp{ std::move(lhs) };
+        lhs = std::move(rhs);
+        rhs = std::move(temp);
+    }
+
+private:
+
+    // Number of items of item_size bytes in the window, validated in debug builds.
+    std::size_t window_size(const std::size_t offset_bytes, const std::size_t item_count, const std::size_t item_size) const
+    {
+        const std::size_t available = (offset_bytes < m_size_in_bytes) ? (m_size_in_bytes - offset_bytes) / item_size : 0;
+
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (offset_bytes > m_size_in_bytes)
+        {
+            ARRAY_VIEW_ERROR("mapped_file: window offset is past the end of the file!");
+        }
+        if (item_count != dynamic_extent && item_count > available)
+        {
+            ARRAY_VIEW_ERROR("mapped_file: window is bigger than the file!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return (item_count == dynamic_extent || item_count > available) ? available : item_count;
+    }
+
+    void take(mapped_file & other) noexcept
+    {
+        m_data          = other.m_data;
+        m_size_in_bytes = other.m_size_in_bytes;
+        m_is_open       = other.m_is_open;
+        #if defined(_WIN32)
+        m_file_handle    = other.m_file_handle;
+        m_mapping_handle = other.m_mapping_handle;
+        other.m_file_handle    = nullptr;
+        other.m_mapping_handle = nullptr;
+        #endif // _WIN32
+        other.m_data          = nullptr;
+        other.m_size_in_bytes = 0;
+        other.m_is_open       = false;
+    }
+
+    const std::uint8_t * m_data          = nullptr;
+    std::size_t          m_size_in_bytes = 0;
+    bool                 m_is_open       = false;
+
+    #if defined(_WIN32)
+    HANDLE m_file_handle    = nullptr;
+    HANDLE m_mapping_handle = nullptr;
+    #endif // _WIN32
+};
+
+#endif // ARRAY_VIEW_MAPPED_FILE_HPP
@@ -0,0 +1,605 @@
+// ================================================================================================
+// -*- C++ -*-
+// File: array_view_packed.hpp
+// Author: Guilherme R. Lampert
+// Created on: 14/10/26
+//
+// About:
+//  packed_array_view<Bits>, a view over an array of unsigned integers of
+//  1 to 32 bits each, packed back to back into 64-bit words. For columns of
+//  flags and small codes it moves a fraction of the memory an array_view
+//  of bytes would. Items are read and written through proxy references,
+//  and bulk unpack/pack use BMI2 pdep/pext when available.
+//
+// License:
+//  This software is in the public domain. Where that dedication is not recognized,
+//  you are granted a perpetual, irrevocable license to copy, distribute, and modify
+//  this file as you see fit. Source code is provided "as is", without warranty of any
+//  kind, express or implied. No attribution is required, but a mention about the author
+//  is appreciated.
+// ================================================================================================
+
+#ifndef ARRAY_VIEW_PACKED_HPP
+#define ARRAY_VIEW_PACKED_HPP
+
+#include "array_view.hpp"
+
+// BMI2 pdep/pext, for the bulk paths. MSVC has no __BMI2__, but all its AVX2 targets have BMI2.
+#ifndef ARRAY_VIEW_NO_SIMD
+    #if defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__))
+        #define ARRAY_VIEW_BMI2 1
+    #endif // __BMI2__ || (_MSC_VER && __AVX2__)
+#endif // ARRAY_VIEW_NO_SIMD
+
+#ifndef ARRAY_VIEW_NO_STD_INCLUDES
+    #if ARRAY_VIEW_BMI2
+        #include <immintrin.h>
+    #endif // ARRAY_VIEW_BMI2
+#endif // ARRAY_VIEW_NO_STD_INCLUDES
+
+// ========================================================
+// packed_array_view helpers:
+// ========================================================
+
+namespace array_view_detail
+{
+    //
+    // Item i takes bits [i * Bits, (i + 1) * Bits) of the word array,
+    // counting from the least significant bit of word 0, so an item may
+    // straddle two words. On little-endian machines that is the same as
+    // packing LSB-first into a byte stream.
+    //
+    template<std::size_t Bits>
+    struct packed_bits
+    {
+        static constexpr std::uint64_t mask = (std::uint64_t(1) << Bits) - 1;
+    };
+
+    template<std::size_t Bits>
+    inline std::uint32_t packed_get(const std::uint64_t * words, const std::size_t index) noexcept
+    {
+        const std::size_t bit    = index * Bits;
+        const std::size_t word   = bit / 64;
+        const unsigned    offset = static_cast<unsigned>(bit % 64);
+
+        std::uint64_t value = words[word] >> offset;
+        if (offset + Bits > 64)
+        {
+            value |= words[word + 1] << (64 - offset);
+        }
+        return static_cast<std::uint32_t>(value & packed_bits<Bits>::mask);
+    }
+
+    template<std::size_t Bits>
+    inline void packed_set(std::uint64_t * words, const std::size_t index, const std::uint32_t value) noexcept
+    {
+        const std::size_t bit    = index * Bits;
+        const std::size_t word   = bit / 64;
+        const unsigned    offset = static_cast<unsigned>(bit % 64);
+        const std::uint64_t bits = value & packed_bits<Bits>::mask;
+
+        words[word] = (words[word] & ~(packed_bits<Bits>::mask << offset)) | (bits << offset);
+        if (offset + Bits > 64)
+        {
+            const unsigned spill = 64 - offset;
+            words[word + 1] = (words[word + 1] & ~(packed_bits<Bits>::mask >> spill)) | (bits >> spill);
+        }
+    }
+
+    inline unsigned population_count64(const std::uint64_t x) noexcept
+    {
+        return population_count(static_cast<std::uint32_t>(x)) + population_count(static_cast<std::uint32_t>(x >> 32));
+    }
+
+    #if ARRAY_VIEW_BMI2
+    //
+    // Items per pdep/pext group: 8 into byte lanes for up to 8 bits,
+    // 4 into 16-bit lanes for up to 16. Wider items use the scalar code.
+    //
+    template<std::size_t Bits>
+    struct packed_group
+    {
+        static constexpr std::size_t items      = (Bits <= 8) ? 8 : 4;
+        static constexpr std::size_t lane_bits  = (Bits <= 8) ? 8 : 16;
+        static constexpr std::uint64_t lane_lsb = (Bits <= 8) ? 0x0101010101010101ull : 0x0001000100010001ull;
+        static constexpr std::uint64_t lanes    = packed_bits<Bits>::mask * lane_lsb;
+        static constexpr bool supported         = (Bits <= 16);
+    };
+
+    inline std::uint64_t deposit_bits(const std::uint64_t source, const std::uint64_t mask) noexcept
+    {
+        return static_cast<std::uint64_t>(_pdep_u64(source, mask));
+    }
+    inline std::uint64_t extract_bits(const std::uint64_t source, const std::uint64_t mask) noexcept
+    {
+        return static_cast<std::uint64_t>(_pext_u64(source, mask));
+    }
+    #endif // ARRAY_VIEW_BMI2
+} // namespace array_view_detail {}
+
+// ========================================================
+// template class packed_reference:
+// ========================================================
+
+//
+// Proxy for one item of a mutable packed_array_view. Converts to the
+// item value and assigns with a read-modify-write of its bits, like
+// std::vector<bool>::reference.
+//
+template<std::size_t Bits>
+class packed_reference final
+{
+public:
+
+    packed_reference(std::uint64_t * words, const std::size_t index) noexcept
+        : m_words{ words }
+        , m_index{ index }
+    { }
+
+    operator std::uint32_t() const noexcept
+    {
+        return array_view_detail::packed_get<Bits>(m_words, m_index);
+    }
+
+    // value must fit in Bits bits.
+    const packed_reference & operator = (const std::uint32_t value) const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (value > array_view_detail::packed_bits<Bits>::mask)
+        {
+            ARRAY_VIEW_ERROR("packed_array_view: value doesn't fit in the item bits!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        array_view_detail::packed_set<Bits>(m_words, m_index, value);
+        return *this;
+    }
+    const packed_reference & operator = (const packed_reference & other) const
+    {
+        return *this = static_cast<std::uint32_t>(other);
+    }
+
+    friend void swap(const packed_reference & lhs, const packed_reference & rhs)
+    {
+        const std::uint32_t temp = lhs;
+        lhs = static_cast<std::uint32_t>(rhs);
+        rhs = temp;
+    }
+
+private:
+
+    std::uint64_t * m_words;
+    std::size_t     m_index;
+};
+
+// ========================================================
+// template class packed_array_iterator:
+// ========================================================
+
+//
+// Random access iterator over the items of a packed_array_view.
+// Holds the word pointer and item index, not the view, so it stays
+// valid after a temporary view goes away. Mutable iterators
+// dereference to packed_reference, const ones to the value.
+//
+template<std::size_t Bits, typename WordType>
+class packed_array_iterator final
+{
+public:
+
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type        = std::uint32_t;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = void;
+    using reference         = typename std::conditional<std::is_const<WordType>::value,
+                                                        std::uint32_t, packed_reference<Bits>>::type;
+
+    packed_array_iterator() noexcept = default;
+
+    packed_array_iterator(WordType * words, const std::size_t index) noexcept
+        : m_words{ words }
+        , m_index{ index }
+    { }
+
+    // Mutable to const conversion.
+    operator packed_array_iterator<Bits, const WordType>() const noexcept
+    {
+        return packed_array_iterator<Bits, const WordType>{ m_words, m_index };
+    }
+
+    reference operator*() const noexcept { return dereference(std::is_const<WordType>{}); }
+    reference operator[](const difference_type n) const noexcept { return *(*this + n); }
+
+    packed_array_iterator & operator++() noexcept { ++m_index; return *this; }
+    packed_array_iterator & operator--() noexcept { --m_index; return *this; }
+    packed_array_iterator operator++(int) noexcept { packed_array_iterator temp{ *this }; ++m_index; return temp; }
+    packed_array_iterator operator--(int) noexcept { packed_array_iterator temp{ *this }; --m_index; return temp; }
+
+    packed_array_iterator & operator += (const difference_type n) noexcept { m_index += n; return *this; }
+    packed_array_iterator & operator -= (const difference_type n) noexcept { m_index -= n; return *this; }
+    packed_array_iterator operator + (const difference_type n) const noexcept { return packed_array_iterator{ m_words, m_index + n }; }
+    packed_array_iterator operator - (const difference_type n) const noexcept { return packed_array_iterator{ m_words, m_index - n }; }
+    friend packed_array_iterator operator + (const difference_type n, const packed_array_iterator & iter) noexcept { return iter + n; }
+    difference_type operator - (const packed_array_iterator & other) const noexcept
+    {
+        return static_cast<difference_type>(m_index) - static_cast<difference_type>(other.m_index);
+    }
+
+    bool operator == (const packed_array_iterator & other) const noexcept { return m_index == other.m_index; }
+    bool operator != (const packed_array_iterator & other) const noexcept { return m_index != other.m_index; }
+    bool operator <  (const packed_array_iterator & other) const noexcept { return m_index <  other.m_index; }
+    bool operator >  (const packed_array_iterator & other) const noexcept { return m_index >  other.m_index; }
+    bool operator <= (const packed_array_iterator & other) const noexcept { return m_index <= other.m_index; }
+    bool operator >= (const packed_array_iterator & other) const noexcept { return m_index >= other.m_index; }
+
+private:
+
+    std::uint32_t dereference(std::true_type /* const */) const noexcept
+    {
+        return array_view_detail::packed_get<Bits>(m_words, m_index);
+    }
+    packed_reference<Bits> dereference(std::false_type /* const */) const noexcept
+    {
+        return packed_reference<Bits>{ m_words, m_index };
+    }
+
+    WordType *  m_words = nullptr;
+    std::size_t m_index = 0;
+};
+
+// ========================================================
+// template class packed_array_view:
+// ========================================================
+
+//
+// View over size() items of Bits bits each, stored in words_for(size())
+// 64-bit words. WordType is std::uint64_t for a mutable view, or const
+// std::uint64_t for a read-only one (const_packed_array_view). Bits
+// past the last item in the last word are left alone by writes.
+//
+//  std::vector<std::uint64_t> storage(packed_array_view<5>::words_for(count));
+//  packed_array_view<5> codes{ storage.data(), count };
+//  codes[i] = 17;
+//  codes.unpack_to(make_array_view(decoded));
+//
+// words() exposes the storage for word-level work, e.g. combining
+// flag columns with bitwise operations a word at a time.
+//
+template
+<
+    std::size_t Bits,
+    typename WordType = std::uint64_t
+>
+class packed_array_view final
+{
+    static_assert(Bits >= 1 && Bits <= 32, "packed_array_view items must be 1 to 32 bits wide!");
+    static_assert(std::is_same<typename std::remove_const<WordType>::type, std::uint64_t>::value,
+                  "packed_array_view WordType must be std::uint64_t or const std::uint64_t!");
+
+    static constexpr bool is_mutable = !std::is_const<WordType>::value;
+
+public:
+
+    //
+    // Nested types:
+    //
+
+    using word_type       = WordType;
+    using value_type      = std::uint32_t;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = typename std::conditional<is_mutable, packed_reference<Bits>, value_type>::type;
+    using const_reference = value_type;
+    using iterator        = packed_array_iterator<Bits, word_type>;
+    using const_iterator  = packed_array_iterator<Bits, const std::uint64_t>;
+
+    static constexpr size_type bits = Bits;
+    static constexpr value_type max_value = static_cast<value_type>(array_view_detail::packed_bits<Bits>::mask);
+
+    // Words needed to store item_count items.
+    static constexpr size_type words_for(const size_type item_count) noexcept
+    {
+        return (item_count * Bits + 63) / 64;
+    }
+
+    //
+    // Constructors / assignment:
+    //
+
+    packed_array_view() noexcept = default;
+
+    // words must hold at least words_for(item_count) words.
+    packed_array_view(word_type * words, const size_type item_count) noexcept
+        : m_words{ words }
+        , m_size{ item_count }
+    { }
+
+    // As many items as fit in the words.
+    explicit packed_array_view(array_view<word_type> words) noexcept
+        : m_words{ words.data() }
+        , m_size{ (words.size() * 64) / Bits }
+    { }
+
+    // Mutable to const conversion.
+    template<typename OtherWordType, typename std::enable_if<std::is_same<const OtherWordType, word_type>::value &&
+                                                             !std::is_same<OtherWordType, word_type>::value, int>::type = 0>
+    packed_array_view(const packed_array_view<Bits, OtherWordType> & other) noexcept
+        : m_words{ other.words().data() }
+        , m_size{ other.size() }
+    { }
+
+    //
+    // Item access:
+    //
+
+    value_type get(const size_type index) const
+    {
+        check_index(index);
+        return array_view_detail::packed_get<Bits>(m_words, index);
+    }
+
+    // value must fit in Bits bits.
+    template<bool M = is_mutable, typename std::enable_if<M, int>::type = 0>
+    void set(const size_type index, const value_type value) const
+    {
+        check_index(index);
+        packed_reference<Bits>{ m_words, index } = value;
+    }
+
+    value_type operator[](const size_type index) const
+    {
+        return get(index);
+    }
+
+    template<bool M = is_mutable, typename std::enable_if<M, int>::type = 0>
+    packed_reference<Bits> operator[](const size_type index)
+    {
+        check_index(index);
+        return packed_reference<Bits>{ m_words, index };
+    }
+
+    value_type at(const size_type index) const
+    {
+        if (m_words == nullptr || index >= m_size)
+        {
+            ARRAY_VIEW_ERROR("packed_array_view::at(): index is out-of-bounds!");
+        }
+        return array_view_detail::packed_get<Bits>(m_words, index);
+    }
+
+    //
+    // Bulk conversion:
+    //
+
+    // Decodes dest.size() items starting at item first into dest.
+    void unpack_to(array_view<std::uint32_t> dest, const size_type first = 0) const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (first > m_size || dest.size() > m_size - first)
+        {
+            ARRAY_VIEW_ERROR("packed_array_view::unpack_to(): range is out-of-bounds!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        std::uint32_t * const out = dest.data();
+        const size_type count = dest.size();
+        size_type i = 0;
+
+        #if ARRAY_VIEW_BMI2
+        using group = array_view_detail::packed_group<Bits>;
+        if (group::supported)
+        {
+            for (; i < count && (first + i) % group::items != 0; ++i)
+            {
+                out[i] = array_view_detail::packed_get<Bits>(m_words, first + i);
+            }
+
+            const auto * const bytes = reinterpret_cast<const std::uint8_t *>(m_words);
+            const size_type storage_bytes = words_for(m_size) * 8;
+            for (; i + group::items <= count; i += group::items)
+            {
+                // A group of 4 items of odd width starts halfway into a byte.
+                const size_type bit = (first + i) * Bits;
+                if (bit / 8 + 8 > storage_bytes)
+                {
+                    break;
+                }
+                std::uint64_t packed;
+                std::memcpy(&packed, bytes + bit / 8, sizeof(packed));
+                const std::uint64_t lanes = array_view_detail::deposit_bits(packed >> (bit % 8), group::lanes);
+                for (size_type lane = 0; lane < group::items; ++lane)
+                {
+                    out[i + lane] = static_cast<std::uint32_t>((lanes >> (lane * group::lane_bits)) & ((std::uint64_t(1) << group::lane_bits) - 1));
+                }
+            }
+        }
+        #endif // ARRAY_VIEW_BMI2
+
+        for (; i < count; ++i)
+        {
+            out[i] = array_view_detail::packed_get<Bits>(m_words, first + i);
+        }
+    }
+
+    // Encodes all source items into the view, starting at item first.
+    // Every value must fit in Bits bits.
+    template<bool M = is_mutable, typename std::enable_if<M, int>::type = 0>
+    void pack_from(array_view<const std::uint32_t> source, const size_type first = 0) const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (first > m_size || source.size() > m_size - first)
+        {
+            ARRAY_VIEW_ERROR("packed_array_view::pack_from(): range is out-of-bounds!");
+        }
+        for (const std::uint32_t value : source)
+        {
+            if (value > max_value)
+            {
+                ARRAY_VIEW_ERROR("packed_array_view::pack_from(): value doesn't fit in the item bits!");
+            }
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        const std::uint32_t * const in = source.data();
+        const size_type count = source.size();
+        size_type i = 0;
+
+        #if ARRAY_VIEW_BMI2
+        // Groups of 8 items of up to 8 bits fill whole bytes, so
+        // they can be stored without touching their neighbours.
+        if (Bits <= 8)
+        {
+            using group = array_view_detail::packed_group<Bits>;
+            constexpr size_type group_bytes = (Bits <= 8) ? Bits : 8;
+            for (; i < count && (first + i) % 8 != 0; ++i)
+            {
+                array_view_detail::packed_set<Bits>(m_words, first + i, in[i]);
+            }
+
+            auto * const bytes = reinterpret_cast<std::uint8_t *>(m_words);
+            for (; i + 8 <= count; i += 8)
+            {
+                std::uint64_t lanes = 0;
+                for (size_type lane = 0; lane < 8; ++lane)
+                {
+                    lanes |= static_cast<std::uint64_t>(in[i + lane] & 0xFF) << (lane * 8);
+                }
+                const std::uint64_t packed = array_view_detail::extract_bits(lanes, group::lanes);
+                std::memcpy(bytes + ((first + i) * Bits) / 8, &packed, group_bytes);
+            }
+        }
+        #endif // ARRAY_VIEW_BMI2
+
+        for (; i < count; ++i)
+        {
+            array_view_detail::packed_set<Bits>(m_words, first + i, in[i]);
+        }
+    }
+
+    //
+    // Queries:
+    //
+
+    // Number of items equal to value. When Bits divides 64, whole words
+    // are compared at once with SWAR arithmetic and a popcount; for
+    // Bits == 1 that is just counting the set bits.
+    size_type count(const value_type value) const noexcept
+    {
+        return count_impl(value, std::integral_constant<bool, (64 % Bits) == 0>{});
+    }
+
+    size_type size() const noexcept
+    {
+        return m_size;
+    }
+    bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    // Bytes of storage used by the items, rounded up to whole words.
+    size_type size_bytes() const noexcept
+    {
+        return words_for(m_size) * sizeof(std::uint64_t);
+    }
+
+    // The underlying words.
+    array_view<word_type> words() const noexcept
+    {
+        return array_view<word_type>{ m_words, words_for(m_size) };
+    }
+
+    //
+    // Iterators:
+    //
+
+    iterator begin() const noexcept { return iterator{ m_words, 0 }; }
+    iterator end()   const noexcept { return iterator{ m_words, m_size }; }
+    const_iterator cbegin() const noexcept { return const_iterator{ m_words, 0 }; }
+    const_iterator cend()   const noexcept { return const_iterator{ m_words, m_size }; }
+
+private:
+
+    void check_index(const size_type index) const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (m_words == nullptr)
+        {
+            ARRAY_VIEW_ERROR("packed_array_view is null!");
+        }
+        if (index >= m_size)
+        {
+            ARRAY_VIEW_ERROR("packed_array_view: index is out-of-bounds!");
+        }
+        #else // !ARRAY_VIEW_DEBUG_CHECKS
+        (void)index;
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+    }
+
+    size_type count_impl(const value_type value, std::true_type /* lanes fit words */) const noexcept
+    {
+        if (value > max_value)
+        {
+            return 0;
+        }
+
+        // Lanes compare equal where value ^ word is zero. The SWAR test
+        // sets the high bit of every lane with any bit set, without
+        // carrying into the next lane.
+        constexpr std::uint64_t lane_lsb  = ~std::uint64_t(0) / array_view_detail::packed_bits<Bits>::mask;
+        constexpr std::uint64_t lane_msb  = lane_lsb << (Bits - 1);
+        constexpr std::uint64_t low_bits  = ~lane_msb;
+        constexpr size_type     per_word  = 64 / Bits;
+        const std::uint64_t     broadcast = value * lane_lsb;
+
+        const size_type full_words = m_size / per_word;
+        size_type mismatches = 0;
+        for (size_type w = 0; w < full_words; ++w)
+        {
+            const std::uint64_t x = m_words[w] ^ broadcast;
+            mismatches += array_view_detail::population_count64((((x & low_bits) + low_bits) | x) & lane_msb);
+        }
+
+        size_type matches = full_words * per_word - mismatches;
+        for (size_type i = full_words * per_word; i < m_size; ++i)
+        {
+            matches += (array_view_detail::packed_get<Bits>(m_words, i) == value) ? 1 : 0;
+        }
+        return matches;
+    }
+
+    size_type count_impl(const value_type value, std::false_type /* lanes fit words */) const noexcept
+    {
+        size_type matches = 0;
+        for (size_type i = 0; i < m_size; ++i)
+        {
+            matches += (array_view_detail::packed_get<Bits>(m_words, i) == value) ? 1 : 0;
+        }
+        return matches;
+    }
+
+    word_type * m_words = nullptr;
+    size_type   m_size  = 0;
+};
+
+template<std::size_t Bits, typename WordType>
+constexpr std::size_t packed_array_view<Bits, WordType>::bits;
+
+template<std::size_t Bits, typename WordType>
+constexpr std::uint32_t packed_array_view<Bits, WordType>::max_value;
+
+template<std::size_t Bits>
+using const_packed_array_view = packed_array_view<Bits, const std::uint64_t>;
+
+// ========================================================
+// make_packed_array_view() helpers:
+// ========================================================
+
+template<std::size_t Bits, typename ContainerType>
+auto make_packed_array_view(ContainerType & words, const std::size_t item_count) noexcept
+    -> packed_array_view<Bits, typename std::remove_pointer<decltype(words.data())>::type>
+{
+    return { words.data(), item_count };
+}
+
+#endif // ARRAY_VIEW_PACKED_HPP
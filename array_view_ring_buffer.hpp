@@ -0,0 +1,449 @@
+// ================================================================================================
+// -*- C++ -*-
+// File: array_view_ring_buffer.hpp
+// Author: Guilherme R. Lampert
+// Created on: 14/10/26
+//
+// About:
+//  Lock-free ring buffer handing out array_view windows to write into and
+//  read from in place, so batches pass between threads without copying.
+//  Single-producer/single-consumer, or multiple producers and one consumer.
+//  On Linux the storage is mapped twice back to back (memfd_create), so a
+//  window is always one contiguous array_view, even across the wrap point.
+//
+// License:
+//  This software is in the public domain. Where that dedication is not recognized,
+//  you are granted a perpetual, irrevocable license to copy, distribute, and modify
+//  this file as you see fit. Source code is provided "as is", without warranty of any
+//  kind, express or implied. No attribution is required, but a mention about the author
+//  is appreciated.
+// ================================================================================================
+
+#ifndef ARRAY_VIEW_RING_BUFFER_HPP
+#define ARRAY_VIEW_RING_BUFFER_HPP
+
+#include "array_view.hpp"
+
+#ifndef ARRAY_VIEW_NO_STD_INCLUDES
+    #include <atomic>
+    #include <memory>
+    #include <thread>
+    #if defined(__linux__)
+        #include <unistd.h>
+        #include <sys/mman.h>
+        #include <sys/syscall.h>
+    #endif // __linux__
+#endif // ARRAY_VIEW_NO_STD_INCLUDES
+
+// Double mapping needs memfd_create, which we call through syscall()
+// so it also works with C libraries that predate the wrapper.
+#ifndef ARRAY_VIEW_RING_BUFFER_DOUBLE_MAPPING
+    #if defined(__linux__) && defined(SYS_memfd_create)
+        #define ARRAY_VIEW_RING_BUFFER_DOUBLE_MAPPING 1
+    #endif // __linux__ && SYS_memfd_create
+#endif // ARRAY_VIEW_RING_BUFFER_DOUBLE_MAPPING
+
+// ========================================================
+// class ring_buffer_window:
+// ========================================================
+
+template<typename T, typename ProducerMode> class ring_buffer;
+
+//
+// A range of ring buffer slots, as up to two array_views: first, then
+// second after the wrap point. second is always empty if the buffer
+// is double mapped, or if the range doesn't cross the wrap point.
+//
+template<typename T>
+class ring_buffer_window final
+{
+public:
+
+    array_view<T> first;
+    array_view<T> second;
+
+    std::size_t size() const noexcept
+    {
+        return first.size() + second.size();
+    }
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+    bool is_contiguous() const noexcept
+    {
+        return second.empty();
+    }
+
+    const T & operator[](const std::size_t index) const
+    {
+        return (index < first.size()) ? first[index] : second[index - first.size()];
+    }
+    T & operator[](const std::size_t index)
+    {
+        return (index < first.size()) ? first[index] : second[index - first.size()];
+    }
+
+    // Copies source into the window, which must be at least as big.
+    void copy_from(array_view<const typename std::remove_const<T>::type> source)
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (source.size() > size())
+        {
+            ARRAY_VIEW_ERROR("ring_buffer_window::copy_from(): source is bigger than the window!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        const std::size_t first_count = std::min(source.size(), first.size());
+        first.copy_from(source.first(first_count));
+        second.copy_from(source.drop_front(first_count));
+    }
+
+private:
+
+    template<typename, typename> friend class ring_buffer;
+
+    // Sequence number of the first slot, for commit_write()/commit_read().
+    std::uint64_t m_sequence = 0;
+};
+
+// ========================================================
+// template class ring_buffer:
+// ========================================================
+
+//
+// Producer modes for ring_buffer.
+//
+struct ring_buffer_single_producer { };
+struct ring_buffer_multi_producer  { };
+
+//
+// Bounded FIFO of trivially copyable items with in-place access.
+// Capacity is rounded up to a power of two (and to whole pages when
+// double mapped).
+//
+// Producer:
+//   auto window = queue.prepare_write(n);  // empty if there's no room for n
+//   ... fill window.first / window.second ...
+//   queue.commit_write(window);            // no-op for an empty window
+//
+// Consumer (one thread only):
+//   auto window = queue.prepare_read();    // everything readable so far
+//   ... use window.first / window.second ...
+//   queue.commit_read(window.size());
+//
+// With ring_buffer_single_producer the single producer can also use
+// prepare_write_up_to() and commit fewer items than it prepared.
+// With ring_buffer_multi_producer, producers reserve slots with a CAS
+// and publish them in reservation order, so commit_write() waits for
+// earlier reservations to be committed first. A producer stalled
+// between the two calls holds up the others' commits, but not their
+// reservations or the consumer.
+//
+template
+<
+    typename T,
+    typename ProducerMode = ring_buffer_single_producer
+>
+class ring_buffer final
+{
+    static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+                  "ring_buffer items must be trivially copyable and destructible!");
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "ring_buffer items can't be over-aligned!");
+
+    static constexpr bool is_multi_producer = std::is_same<ProducerMode, ring_buffer_multi_producer>::value;
+
+public:
+
+    using value_type   = T;
+    using size_type    = std::size_t;
+    using window_type  = ring_buffer_window<T>;
+    using read_window  = ring_buffer_window<const T>;
+
+    //
+    // Constructors / assignment:
+    //
+
+    // At least min_capacity items. Falls back to a normal heap
+    // allocation if double mapping is disabled or not available.
+    explicit ring_buffer(const size_type min_capacity, const bool allow_double_mapping = true)
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (min_capacity == 0)
+        {
+            ARRAY_VIEW_ERROR("ring_buffer with zero capacity!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        m_capacity = 1;
+        while (m_capacity < min_capacity)
+        {
+            m_capacity <<= 1;
+        }
+
+        #if ARRAY_VIEW_RING_BUFFER_DOUBLE_MAPPING
+        if (allow_double_mapping && map_twice())
+        {
+            return;
+        }
+        #else // !ARRAY_VIEW_RING_BUFFER_DOUBLE_MAPPING
+        (void)allow_double_mapping;
+        #endif // ARRAY_VIEW_RING_BUFFER_DOUBLE_MAPPING
+
+        m_heap_storage.reset(new T[m_capacity]);
+        m_items = m_heap_storage.get();
+    }
+
+    ~ring_buffer()
+    {
+        #if ARRAY_VIEW_RING_BUFFER_DOUBLE_MAPPING
+        if (m_double_mapped)
+        {
+            ::munmap(m_items, 2 * m_capacity * sizeof(T));
+        }
+        #endif // ARRAY_VIEW_RING_BUFFER_DOUBLE_MAPPING
+    }
+
+    // Shared between threads by reference; never copied or moved.
+    ring_buffer(const ring_buffer &) = delete;
+    ring_buffer & operator = (const ring_buffer &) = delete;
+
+    //
+    // Producer side:
+    //
+
+    // Exactly count free slots, or an empty window if there isn't room.
+    window_type prepare_write(const size_type count)
+    {
+        return prepare_write(count, ProducerMode{});
+    }
+
+    // Up to max_count free slots. Single producer only.
+    window_type prepare_write_up_to(const size_type max_count)
+    {
+        static_assert(!is_multi_producer, "prepare_write_up_to() needs a single producer!");
+        return prepare_write_up_to_impl(max_count);
+    }
+
+    // Publishes the first count items of a prepared window to the consumer.
+    // Multiple producers must commit the whole window. Committing zero items,
+    // e.g. the empty window of a failed prepare_write(), does nothing.
+    void commit_write(const window_type & window, const size_type count)
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (count > window.size() || (is_multi_producer && count != window.size()))
+        {
+            ARRAY_VIEW_ERROR("ring_buffer::commit_write(): bad item count!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        // An empty window has no reserved sequence to publish.
+        if (count == 0)
+        {
+            return;
+        }
+
+        if (is_multi_producer)
+        {
+            // Earlier reservations go first, so the consumer sees no gaps.
+            unsigned spins = 0;
+            while (m_write_commit.load(std::memory_order_acquire) != window.m_sequence)
+            {
+                if (++spins > 64)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        m_write_commit.store(window.m_sequence + count, std::memory_order_release);
+    }
+
+    void commit_write(const window_type & window)
+    {
+        commit_write(window, window.size());
+    }
+
+    //
+    // Consumer side (one thread):
+    //
+
+    // Up to max_count items written and committed by the producers.
+    read_window prepare_read(const size_type max_count = static_cast<size_type>(-1))
+    {
+        const std::uint64_t read_seq = m_read.load(std::memory_order_relaxed);
+        size_type available = static_cast<size_type>(m_cached_commit - read_seq);
+        if (available < max_count)
+        {
+            m_cached_commit = m_write_commit.load(std::memory_order_acquire);
+            available = static_cast<size_type>(m_cached_commit - read_seq);
+        }
+        return make_window<const T>(read_seq, std::min(available, max_count));
+    }
+
+    // Frees the oldest count items for the producers.
+    void commit_read(const size_type count)
+    {
+        const std::uint64_t read_seq = m_read.load(std::memory_order_relaxed);
+
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (count > static_cast<size_type>(m_cached_commit - read_seq))
+        {
+            ARRAY_VIEW_ERROR("ring_buffer::commit_read(): more items than were prepared!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        m_read.store(read_seq + count, std::memory_order_release);
+    }
+
+    //
+    // Miscellaneous queries:
+    //
+
+    size_type capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+    // Snapshot only, the other side may be changing it concurrently.
+    size_type size() const noexcept
+    {
+        return static_cast<size_type>(m_write_commit.load(std::memory_order_acquire) -
+                                      m_read.load(std::memory_order_acquire));
+    }
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    // True if windows never wrap (second is always empty).
+    bool is_double_mapped() const noexcept
+    {
+        return m_double_mapped;
+    }
+
+private:
+
+    window_type prepare_write(const size_type count, ring_buffer_single_producer)
+    {
+        window_type window = prepare_write_up_to_impl(count);
+        return (window.size() == count) ? window : window_type{};
+    }
+
+    window_type prepare_write(const size_type count, ring_buffer_multi_producer)
+    {
+        std::uint64_t reserve_seq = m_write_reserve.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            const std::uint64_t read_seq = m_read.load(std::memory_order_acquire);
+            if (m_capacity - static_cast<size_type>(reserve_seq - read_seq) < count)
+            {
+                return {};
+            }
+            if (m_write_reserve.compare_exchange_weak(reserve_seq, reserve_seq + count,
+                                                      std::memory_order_relaxed, std::memory_order_relaxed))
+            {
+                return make_window<T>(reserve_seq, count);
+            }
+        }
+    }
+
+    window_type prepare_write_up_to_impl(const size_type max_count)
+    {
+        const std::uint64_t write_seq = m_write_commit.load(std::memory_order_relaxed);
+        size_type free_slots = m_capacity - static_cast<size_type>(write_seq - m_cached_read);
+        if (free_slots < max_count)
+        {
+            m_cached_read = m_read.load(std::memory_order_acquire);
+            free_slots = m_capacity - static_cast<size_type>(write_seq - m_cached_read);
+        }
+        return make_window<T>(write_seq, std::min(free_slots, max_count));
+    }
+
+    template<typename ItemType>
+    ring_buffer_window<ItemType> make_window(const std::uint64_t sequence, const size_type count) const noexcept
+    {
+        ring_buffer_window<ItemType> window;
+        window.m_sequence = sequence;
+
+        const size_type start = static_cast<size_type>(sequence) & (m_capacity - 1);
+        if (m_double_mapped || start + count <= m_capacity)
+        {
+            window.first = array_view<ItemType>{ m_items + start, count };
+        }
+        else
+        {
+            window.first  = array_view<ItemType>{ m_items + start, m_capacity - start };
+            window.second = array_view<ItemType>{ m_items, count - (m_capacity - start) };
+        }
+        return window;
+    }
+
+    #if ARRAY_VIEW_RING_BUFFER_DOUBLE_MAPPING
+    // Maps one memfd twice, back to back, so slot i and slot
+    // i + capacity are the same memory. Returns false on failure.
+    bool map_twice()
+    {
+        const size_type page_size = static_cast<size_type>(::sysconf(_SC_PAGESIZE));
+        while ((m_capacity * sizeof(T)) % page_size != 0)
+        {
+            m_capacity <<= 1;
+        }
+        const size_type size_in_bytes = m_capacity * sizeof(T);
+
+        const int fd = static_cast<int>(::syscall(SYS_memfd_create, "array_view_ring_buffer", 1u /* MFD_CLOEXEC */));
+        if (fd < 0)
+        {
+            return false;
+        }
+        if (::ftruncate(fd, static_cast<off_t>(size_in_bytes)) != 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        // Reserve the address range, then map the file over each half.
+        void * const base = ::mmap(nullptr, 2 * size_in_bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        auto * const base_bytes = static_cast<std::uint8_t *>(base);
+        const bool mapped = ::mmap(base_bytes, size_in_bytes, PROT_READ | PROT_WRITE,
+                                   MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED &&
+                            ::mmap(base_bytes + size_in_bytes, size_in_bytes, PROT_READ | PROT_WRITE,
+                                   MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED;
+        ::close(fd); // The mappings keep the memory alive.
+
+        if (!mapped)
+        {
+            ::munmap(base, 2 * size_in_bytes);
+            return false;
+        }
+
+        m_items = reinterpret_cast<T *>(base_bytes);
+        m_double_mapped = true;
+        return true;
+    }
+    #endif // ARRAY_VIEW_RING_BUFFER_DOUBLE_MAPPING
+
+    // Written by the producer(s). Sequence numbers only ever grow,
+    // the slot index is sequence & (capacity - 1).
+    alignas(ARRAY_VIEW_CACHE_LINE_SIZE) std::atomic<std::uint64_t> m_write_reserve{ 0 }; // Multi-producer only.
+    alignas(ARRAY_VIEW_CACHE_LINE_SIZE) std::atomic<std::uint64_t> m_write_commit{ 0 };
+    std::uint64_t m_cached_read = 0; // Single producer's copy of m_read.
+
+    // Written by the consumer.
+    alignas(ARRAY_VIEW_CACHE_LINE_SIZE) std::atomic<std::uint64_t> m_read{ 0 };
+    std::uint64_t m_cached_commit = 0; // Consumer's copy of m_write_commit.
+
+    // Read-only after construction.
+    alignas(ARRAY_VIEW_CACHE_LINE_SIZE) T * m_items = nullptr;
+    size_type m_capacity = 0;
+    bool m_double_mapped = false;
+    std::unique_ptr<T[]> m_heap_storage;
+};
+
+#endif // ARRAY_VIEW_RING_BUFFER_HPP
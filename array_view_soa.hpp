@@ -0,0 +1,431 @@
+// ================================================================================================
+// -*- C++ -*-
+// File: array_view_soa.hpp
+// Author: Guilherme R. Lampert
+// Created on: 14/10/26
+//
+// About:
+//  soa_view<Ts...>, a structure-of-arrays view bundling N parallel
+//  array_view columns that share a single size. The SoA counterpart
+//  of strided_array_view, which covers the array-of-structures case.
+//
+// License:
+//  This software is in the public domain. Where that dedication is not recognized,
+//  you are granted a perpetual, irrevocable license to copy, distribute, and modify
+//  this file as you see fit. Source code is provided "as is", without warranty of any
+//  kind, express or implied. No attribution is required, but a mention about the author
+//  is appreciated.
+// ================================================================================================
+
+#ifndef ARRAY_VIEW_SOA_HPP
+#define ARRAY_VIEW_SOA_HPP
+
+#include "array_view.hpp"
+
+#ifndef ARRAY_VIEW_NO_STD_INCLUDES
+    #include <tuple>
+#endif // ARRAY_VIEW_NO_STD_INCLUDES
+
+template<typename... Ts>
+class soa_view;
+
+// ========================================================
+// template class soa_iterator:
+// ========================================================
+
+//
+// Zipped iterator over the columns of a soa_view.
+// Dereferencing yields a std::tuple<Ts&...> proxy by
+// value, so it works with structured bindings in C++17:
+//
+//  for (auto [x, y, z] : positions) { ... }
+//
+// Only the index moves, the column pointers are fixed,
+// so stepping costs the same as a single pointer.
+//
+template<typename... Ts>
+class soa_iterator final
+{
+public:
+
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type        = std::tuple<typename std::remove_const<Ts>::type...>;
+    using reference         = std::tuple<Ts &...>;
+    using pointer           = void;
+    using difference_type   = std::ptrdiff_t;
+    using size_type         = std::size_t;
+    using column_ptrs_type  = std::tuple<Ts *...>;
+
+    soa_iterator() noexcept
+        : m_columns{}
+        , m_index{ 0 }
+    { }
+
+    soa_iterator(const column_ptrs_type & columns, const size_type index) noexcept
+        : m_columns{ columns }
+        , m_index{ index }
+    { }
+
+    //
+    // Dereference:
+    //
+
+    reference operator*() const noexcept
+    {
+        return deref(m_index, array_view_detail::make_index_sequence<sizeof...(Ts)>{});
+    }
+    reference operator[](const difference_type index) const noexcept
+    {
+        return deref(m_index + index, array_view_detail::make_index_sequence<sizeof...(Ts)>{});
+    }
+
+    //
+    // Arithmetic:
+    //
+
+    soa_iterator & operator++() noexcept
+    {
+        ++m_index;
+        return *this;
+    }
+    soa_iterator operator++(int) noexcept
+    {
+        soa_iterator temp{ *this };
+        ++m_index;
+        return temp;
+    }
+    soa_iterator & operator--() noexcept
+    {
+        --m_index;
+        return *this;
+    }
+    soa_iterator operator--(int) noexcept
+    {
+        soa_iterator temp{ *this };
+        --m_index;
+        return temp;
+    }
+    soa_iterator & operator += (const difference_type displacement) noexcept
+    {
+        m_index += displacement;
+        return *this;
+    }
+    soa_iterator & operator -= (const difference_type displacement) noexcept
+    {
+        m_index -= displacement;
+        return *this;
+    }
+    soa_iterator operator + (const difference_type displacement) const noexcept
+    {
+        return soa_iterator{ m_columns, m_index + displacement };
+    }
+    soa_iterator operator - (const difference_type displacement) const noexcept
+    {
+        return soa_iterator{ m_columns, m_index - displacement };
+    }
+    difference_type operator - (const soa_iterator & other) const noexcept
+    {
+        return static_cast<difference_type>(m_index) - static_cast<difference_type>(other.m_index);
+    }
+    friend soa_iterator operator + (const difference_type displacement, const soa_iterator & iter) noexcept
+    {
+        return iter + displacement;
+    }
+
+    //
+    // Comparison (iterators of the same soa_view only):
+    //
+
+    bool operator == (const soa_iterator & other) const noexcept { return m_index == other.m_index; }
+    bool operator != (const soa_iterator & other) const noexcept { return m_index != other.m_index; }
+    bool operator <  (const soa_iterator & other) const noexcept { return m_index <  other.m_index; }
+    bool operator >  (const soa_iterator & other) const noexcept { return m_index >  other.m_index; }
+    bool operator <= (const soa_iterator & other) const noexcept { return m_index <= other.m_index; }
+    bool operator >= (const soa_iterator & other) const noexcept { return m_index >= other.m_index; }
+
+private:
+
+    template<std::size_t... Is>
+    reference deref(const size_type index, array_view_detail::index_sequence<Is...>) const noexcept
+    {
+        return reference{ std::get<Is>(m_columns)[index]... };
+    }
+
+    column_ptrs_type m_columns;
+    size_type        m_index;
+};
+
+// ========================================================
+// template class soa_view:
+// ========================================================
+
+//
+// Non-owning view over N parallel arrays of the same length.
+// Keeps one size for all columns, so they can't go out of sync,
+// and slices them in lockstep. column<I>() hands out a plain
+// array_view of one column for SIMD kernels.
+//
+//  std::vector<float> x, y, z;
+//  auto positions = make_soa_view(x, y, z);
+//  positions.column<1>()[i] == y[i];
+//  std::get<2>(positions[i]) == z[i];
+//
+template<typename... Ts>
+class soa_view final
+{
+    static_assert(sizeof...(Ts) > 0, "soa_view needs at least one column!");
+
+public:
+
+    //
+    // Nested types:
+    //
+
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+    using value_type             = std::tuple<typename std::remove_const<Ts>::type...>;
+    using reference              = std::tuple<Ts &...>;
+    using const_reference        = std::tuple<const Ts &...>;
+    using column_ptrs_type       = std::tuple<Ts *...>;
+
+    using iterator               = soa_iterator<Ts...>;
+    using const_iterator         = soa_iterator<const Ts...>;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    template<std::size_t I>
+    using column_value_type = typename std::tuple_element<I, std::tuple<Ts...>>::type;
+
+    template<std::size_t I>
+    using column_view_type = array_view<column_value_type<I>>;
+
+    static constexpr size_type column_count = sizeof...(Ts);
+
+    //
+    // Constructors / assignment:
+    //
+
+    soa_view() noexcept
+        : m_columns{}
+        , m_size_in_items{ 0 }
+    { }
+
+    // All columns must have the same size. Static extent views convert implicitly.
+    soa_view(array_view<Ts>... columns) ARRAY_VIEW_UNCHECKED_NOEXCEPT
+        : m_columns{ columns.data()... }
+        , m_size_in_items{ first_size(columns.size()...) }
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        check_sizes(columns.size()...);
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+    }
+
+    // size_in_items items starting at each pointer.
+    soa_view(const size_type size_in_items, Ts *... column_ptrs) noexcept
+        : m_columns{ column_ptrs... }
+        , m_size_in_items{ size_in_items }
+    { }
+
+    // Ts... to const Ts...
+    template<typename... ConvertibleTypes,
+             typename std::enable_if<sizeof...(ConvertibleTypes) == sizeof...(Ts) &&
+                                     std::is_convertible<std::tuple<ConvertibleTypes *...>, column_ptrs_type>::value, int>::type = 0>
+    soa_view(const soa_view<ConvertibleTypes...> & other) noexcept
+        : m_columns{ other.columns() }
+        , m_size_in_items{ other.size() }
+    { }
+
+    //
+    // Sub-views:
+    //
+
+    // All columns starting at offset, until the end.
+    soa_view slice(const size_type offset) const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (offset > size())
+        {
+            ARRAY_VIEW_ERROR("soa_view::slice(): offset is out-of-bounds!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return soa_view{ offset_columns(offset, array_view_detail::make_index_sequence<sizeof...(Ts)>{}), size() - offset };
+    }
+
+    // count items of all columns starting at offset.
+    soa_view slice(const size_type offset, const size_type count) const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (offset > size() || count > size() - offset)
+        {
+            ARRAY_VIEW_ERROR("soa_view::slice(): slice range is out-of-bounds!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return soa_view{ offset_columns(offset, array_view_detail::make_index_sequence<sizeof...(Ts)>{}), count };
+    }
+
+    // Column I as a contiguous array_view.
+    template<std::size_t I>
+    column_view_type<I> column() const noexcept
+    {
+        static_assert(I < sizeof...(Ts), "soa_view::column(): column index is out-of-range!");
+        return column_view_type<I>{ std::get<I>(m_columns), size() };
+    }
+
+    // Calls func(Ts&...) for each item, with the columns unpacked as separate arguments.
+    template<typename Func>
+    void for_each(Func && func) const
+    {
+        const size_type count = size();
+        for (size_type i = 0; i < count; ++i)
+        {
+            invoke_at(func, i, array_view_detail::make_index_sequence<sizeof...(Ts)>{});
+        }
+    }
+
+    //
+    // Data access:
+    //
+
+    reference at(const size_type index) const
+    {
+        // Always checked.
+        if (index >= size())
+        {
+            ARRAY_VIEW_ERROR("soa_view::at(): index is out-of-bounds!");
+        }
+        return (*this)[index];
+    }
+
+    reference operator[](const size_type index) const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (index >= size())
+        {
+            ARRAY_VIEW_ERROR("soa_view::operator[]: index is out-of-bounds!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return *iterator{ m_columns, index };
+    }
+
+    reference front() const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (empty())
+        {
+            ARRAY_VIEW_ERROR("soa_view::front(): view is empty!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return (*this)[0];
+    }
+
+    reference back() const
+    {
+        #if ARRAY_VIEW_DEBUG_CHECKS
+        if (empty())
+        {
+            ARRAY_VIEW_ERROR("soa_view::back(): view is empty!");
+        }
+        #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+        return (*this)[size() - 1];
+    }
+
+    //
+    // Miscellaneous queries:
+    //
+
+    size_type size() const noexcept { return m_size_in_items; }
+    bool empty() const noexcept { return m_size_in_items == 0; }
+    const column_ptrs_type & columns() const noexcept { return m_columns; }
+
+    //
+    // Begin/end range iterators:
+    //
+
+    iterator begin() const noexcept { return iterator{ m_columns, 0 }; }
+    iterator end()   const noexcept { return iterator{ m_columns, size() }; }
+
+    const_iterator cbegin() const noexcept { return const_iterator{ m_columns, 0 }; }
+    const_iterator cend()   const noexcept { return const_iterator{ m_columns, size() }; }
+
+    reverse_iterator rbegin() const noexcept { return reverse_iterator{ end() }; }
+    reverse_iterator rend()   const noexcept { return reverse_iterator{ begin() }; }
+
+    const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator{ cend() }; }
+    const_reverse_iterator crend()   const noexcept { return const_reverse_iterator{ cbegin() }; }
+
+    //
+    // Swap with another soa_view:
+    //
+
+    friend void swap(soa_view & lhs, soa_view & rhs) noexcept
+    {
+        using std::swap;
+        swap(lhs.m_columns, rhs.m_columns);
+        swap(lhs.m_size_in_items, rhs.m_size_in_items);
+    }
+
+private:
+
+    soa_view(const column_ptrs_type & columns, const size_type size_in_items) noexcept
+        : m_columns{ columns }
+        , m_size_in_items{ size_in_items }
+    { }
+
+    template<typename... Sizes>
+    static size_type first_size(const size_type first, Sizes...) noexcept
+    {
+        return first;
+    }
+
+    #if ARRAY_VIEW_DEBUG_CHECKS
+    template<typename... Sizes>
+    static void check_sizes(const size_type first, const Sizes... others)
+    {
+        (void)array_view_detail::swallow{ 0, (check_size(first, others), 0)... };
+    }
+    static void check_size(const size_type expected, const size_type actual)
+    {
+        if (expected != actual)
+        {
+            ARRAY_VIEW_ERROR("soa_view columns have different sizes!");
+        }
+    }
+    #endif // ARRAY_VIEW_DEBUG_CHECKS
+
+    template<std::size_t... Is>
+    column_ptrs_type offset_columns(const size_type offset, array_view_detail::index_sequence<Is...>) const noexcept
+    {
+        return column_ptrs_type{ (std::get<Is>(m_columns) + offset)... };
+    }
+
+    template<typename Func, std::size_t... Is>
+    void invoke_at(Func & func, const size_type index, array_view_detail::index_sequence<Is...>) const
+    {
+        func(std::get<Is>(m_columns)[index]...);
+    }
+
+    column_ptrs_type m_columns;
+    size_type        m_size_in_items;
+};
+
+template<typename... Ts>
+constexpr std::size_t soa_view<Ts...>::column_count;
+
+// ========================================================
+// make_soa_view() helpers:
+// ========================================================
+
+// Any mix of array_views, containers with data()/size() and C-style arrays.
+template<typename... ContainerTypes>
+auto make_soa_view(ContainerTypes &... containers) ARRAY_VIEW_UNCHECKED_NOEXCEPT
+    -> soa_view<typename std::remove_pointer<decltype(make_array_view(containers).data())>::type...>
+{
+    return soa_view<typename std::remove_pointer<decltype(make_array_view(containers).data())>::type...>{ make_array_view(containers)... };
+}
+
+#endif // ARRAY_VIEW_SOA_HPP
@@ -0,0 +1,551 @@
+// ================================================================================================
+// -*- C++ -*-
+// File: array_view_bench.cpp
+// Author: Guilherme R. Lampert
+// Created on: 14/10/26
+//
+// About:
+//  Microbenchmarks comparing array_view, strided_array_view, raw pointers
+//  and std::span (C++20) on the hot paths: iteration, random access, slicing,
+//  operator==, strided access and the Standard algorithms through iterators.
+//  Self-contained, no benchmark library needed. Build with optimizations
+//  and without DEBUG/_DEBUG so ARRAY_VIEW_DEBUG_CHECKS is off, e.g.:
+//
+//   c++ -std=c++17 -O2 -march=native -I.. array_view_bench.cpp -o array_view_bench
+//
+//  Output is one CSV line per benchmark (name,type,bytes,ns_per_item), stable
+//  across runs so results of two commits can be diffed or joined directly.
+//  Arguments: --quick for smaller sizes and shorter runs, --filter=<substring>
+//  to run only matching benchmarks.
+//
+// License:
+//  This software is in the public domain. Where that dedication is not recognized,
+//  you are granted a perpetual, irrevocable license to copy, distribute, and modify
+//  this file as you see fit. Source code is provided "as is", without warranty of any
+//  kind, express or implied. No attribution is required, but a mention about the author
+//  is appreciated.
+// ================================================================================================
+
+#include "array_view.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#if __cplusplus >= 202002L && defined(__has_include)
+    #if __has_include(<span>)
+        #include <span>
+        #define BENCH_HAS_STD_SPAN 1
+    #endif // __has_include(<span>)
+#endif // C++20
+
+// ========================================================
+// Harness:
+// ========================================================
+
+namespace
+{
+
+struct bench_config
+{
+    double      min_seconds = 0.1; // Minimum time per repetition.
+    int         repetitions = 5;   // Best repetition is reported.
+    std::string filter;
+    bool        quick       = false;
+};
+
+bench_config g_config;
+
+// Keeps the optimizer from discarding a computed value.
+template<typename T>
+inline void do_not_optimize(const T & value)
+{
+    #if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+    #else // !__GNUC__ && !__clang__
+    static volatile char sink;
+    sink = *reinterpret_cast<const volatile char *>(&value);
+    #endif // __GNUC__ || __clang__
+}
+
+// Keeps the optimizer from assuming memory didn't change between iterations.
+inline void clobber_memory()
+{
+    #if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+    #endif // __GNUC__ || __clang__
+}
+
+// Calls func() (which processes items_per_call items) until min_seconds
+// elapse, repetitions times, and prints the best time per item.
+template<typename Func>
+void run_bench(const char * name, const char * type_name, const std::size_t bytes,
+               const std::size_t items_per_call, Func && func)
+{
+    std::string full_name = std::string(name) + "," + type_name;
+    if (!g_config.filter.empty() && full_name.find(g_config.filter) == std::string::npos)
+    {
+        return;
+    }
+
+    using clock = std::chrono::steady_clock;
+    double best_ns_per_item = 1e300;
+
+    func(); // Warm up caches and page in the memory.
+
+    for (int rep = 0; rep < g_config.repetitions; ++rep)
+    {
+        std::size_t calls = 0;
+        const auto start  = clock::now();
+        double elapsed    = 0.0;
+        do
+        {
+            func();
+            ++calls;
+            elapsed = std::chrono::duration<double>(clock::now() - start).count();
+        } while (elapsed < g_config.min_seconds);
+
+        const double ns_per_item = (elapsed * 1e9) / (static_cast<double>(calls) * static_cast<double>(items_per_call));
+        if (ns_per_item < best_ns_per_item)
+        {
+            best_ns_per_item = ns_per_item;
+        }
+    }
+
+    std::printf("%s,%zu,%.4f\n", full_name.c_str(), bytes, best_ns_per_item);
+    std::fflush(stdout);
+}
+
+template<typename T> const char * type_name();
+template<> const char * type_name<std::int32_t>() { return "int32"; }
+template<> const char * type_name<float>() { return "float"; }
+template<> const char * type_name<double>() { return "double"; }
+
+// Working sets from L1 to DRAM.
+std::vector<std::size_t> working_set_bytes()
+{
+    if (g_config.quick)
+    {
+        return { 16 * 1024, 4 * 1024 * 1024 };
+    }
+    return { 16 * 1024, 256 * 1024, 4 * 1024 * 1024, 64 * 1024 * 1024 };
+}
+
+template<typename T>
+std::vector<T> make_data(const std::size_t count)
+{
+    std::vector<T> data(count);
+    std::mt19937 rng{ 1234 };
+    for (auto & item : data)
+    {
+        item = static_cast<T>(rng() % 1000);
+    }
+    return data;
+}
+
+// ========================================================
+// Contiguous benchmarks:
+// ========================================================
+
+template<typename T>
+void bench_iteration(std::vector<T> & data, const std::size_t bytes)
+{
+    const T * const ptr   = data.data();
+    const std::size_t count = data.size();
+    const char * tname    = type_name<T>();
+
+    run_bench("iterate/raw_ptr", tname, bytes, count, [&] {
+        T sum{};
+        for (const T * it = ptr, * end = ptr + count; it != end; ++it) { sum += *it; }
+        do_not_optimize(sum);
+    });
+    run_bench("iterate/array_view_iter", tname, bytes, count, [&] {
+        const array_view<const T> view{ ptr, count };
+        T sum{};
+        for (const T & item : view) { sum += item; }
+        do_not_optimize(sum);
+    });
+    run_bench("iterate/array_view_index", tname, bytes, count, [&] {
+        const array_view<const T> view{ ptr, count };
+        T sum{};
+        for (std::size_t i = 0; i < view.size(); ++i) { sum += view[i]; }
+        do_not_optimize(sum);
+    });
+    #if BENCH_HAS_STD_SPAN
+    run_bench("iterate/std_span", tname, bytes, count, [&] {
+        const std::span<const T> view{ ptr, count };
+        T sum{};
+        for (const T & item : view) { sum += item; }
+        do_not_optimize(sum);
+    });
+    #endif // BENCH_HAS_STD_SPAN
+}
+
+template<typename T>
+void bench_random_access(std::vector<T> & data, const std::size_t bytes)
+{
+    const T * const ptr   = data.data();
+    const std::size_t count = data.size();
+    const char * tname    = type_name<T>();
+
+    std::vector<std::uint32_t> indexes(4096);
+    std::mt19937 rng{ 42 };
+    for (auto & index : indexes)
+    {
+        index = static_cast<std::uint32_t>(rng() % count);
+    }
+    const std::uint32_t * const idx = indexes.data();
+    const std::size_t num_indexes   = indexes.size();
+
+    run_bench("random_access/raw_ptr", tname, bytes, num_indexes, [&] {
+        T sum{};
+        for (std::size_t i = 0; i < num_indexes; ++i) { sum += ptr[idx[i]]; }
+        do_not_optimize(sum);
+    });
+    run_bench("random_access/array_view", tname, bytes, num_indexes, [&] {
+        const array_view<const T> view{ ptr, count };
+        T sum{};
+        for (std::size_t i = 0; i < num_indexes; ++i) { sum += view[idx[i]]; }
+        do_not_optimize(sum);
+    });
+    #if BENCH_HAS_STD_SPAN
+    run_bench("random_access/std_span", tname, bytes, num_indexes, [&] {
+        const std::span<const T> view{ ptr, count };
+        T sum{};
+        for (std::size_t i = 0; i < num_indexes; ++i) { sum += view[idx[i]]; }
+        do_not_optimize(sum);
+    });
+    #endif // BENCH_HAS_STD_SPAN
+}
+
+template<typename T>
+void bench_slice(std::vector<T> & data, const std::size_t bytes)
+{
+    const T * const ptr   = data.data();
+    const std::size_t count = data.size();
+    const std::size_t width = 16;
+    const char * tname    = type_name<T>();
+
+    // Sliding window of 16 items, the slice cost dominates.
+    run_bench("slice/raw_ptr", tname, bytes, count - width, [&] {
+        T sum{};
+        for (std::size_t i = 0; i + width < count; ++i) { const T * window = ptr + i; sum += window[width - 1]; }
+        do_not_optimize(sum);
+    });
+    run_bench("slice/array_view", tname, bytes, count - width, [&] {
+        const array_view<const T> view{ ptr, count };
+        T sum{};
+        for (std::size_t i = 0; i + width < count; ++i) { sum += view.slice(i, width).back(); }
+        do_not_optimize(sum);
+    });
+    run_bench("slice/array_view_unchecked", tname, bytes, count - width, [&] {
+        const array_view<const T> view{ ptr, count };
+        T sum{};
+        for (std::size_t i = 0; i + width < count; ++i) { sum += view.drop_front(i).first(width).back(); }
+        do_not_optimize(sum);
+    });
+    #if BENCH_HAS_STD_SPAN
+    run_bench("slice/std_span", tname, bytes, count - width, [&] {
+        const std::span<const T> view{ ptr, count };
+        T sum{};
+        for (std::size_t i = 0; i + width < count; ++i) { sum += view.subspan(i, width).back(); }
+        do_not_optimize(sum);
+    });
+    #endif // BENCH_HAS_STD_SPAN
+}
+
+template<typename T>
+void bench_equality(std::vector<T> & data, const std::size_t bytes)
+{
+    const std::vector<T> copy = data;
+    const std::size_t count   = data.size();
+    const char * tname        = type_name<T>();
+
+    run_bench("equal/memcmp", tname, bytes, count, [&] {
+        const bool result = std::memcmp(data.data(), copy.data(), count * sizeof(T)) == 0;
+        do_not_optimize(result);
+    });
+    run_bench("equal/array_view", tname, bytes, count, [&] {
+        const array_view<const T> lhs = make_array_view(data);
+        const bool result = lhs == make_array_view(copy);
+        do_not_optimize(result);
+    });
+    run_bench("equal/std_equal", tname, bytes, count, [&] {
+        const bool result = std::equal(data.begin(), data.end(), copy.begin());
+        do_not_optimize(result);
+    });
+}
+
+template<typename T>
+void bench_algorithms(std::vector<T> & data, const std::size_t bytes)
+{
+    const std::size_t count = data.size();
+    const char * tname      = type_name<T>();
+
+    run_bench("accumulate/raw_ptr", tname, bytes, count, [&] {
+        do_not_optimize(std::accumulate(data.data(), data.data() + count, T{}));
+    });
+    run_bench("accumulate/array_view", tname, bytes, count, [&] {
+        const array_view<const T> view = make_array_view(data);
+        do_not_optimize(std::accumulate(view.begin(), view.end(), T{}));
+    });
+    run_bench("accumulate/for_each_prefetched", tname, bytes, count, [&] {
+        T sum{};
+        for_each_prefetched(make_array_view(data), [&sum](const T value) { sum += value; });
+        do_not_optimize(sum);
+    });
+
+    // Items are all below 1000, so find() scans the whole view.
+    run_bench("find/std_find", tname, bytes, count, [&] {
+        const array_view<const T> view = make_array_view(data);
+        do_not_optimize(std::find(view.begin(), view.end(), T{ 1000 }));
+    });
+    run_bench("find/array_view", tname, bytes, count, [&] {
+        do_not_optimize(make_array_view(data).find(T{ 1000 }));
+    });
+    run_bench("count/std_count", tname, bytes, count, [&] {
+        const array_view<const T> view = make_array_view(data);
+        do_not_optimize(std::count(view.begin(), view.end(), T{ 7 }));
+    });
+    run_bench("count/array_view", tname, bytes, count, [&] {
+        do_not_optimize(make_array_view(data).count(T{ 7 }));
+    });
+
+    // Sorting the full DRAM-sized set takes too long per call.
+    if (bytes > 4 * 1024 * 1024)
+    {
+        return;
+    }
+
+    std::vector<T> scratch(count);
+    run_bench("sort/raw_ptr", tname, bytes, count, [&] {
+        std::copy(data.begin(), data.end(), scratch.begin());
+        std::sort(scratch.data(), scratch.data() + count);
+        clobber_memory();
+    });
+    run_bench("sort/array_view", tname, bytes, count, [&] {
+        std::copy(data.begin(), data.end(), scratch.begin());
+        array_view<T> view = make_array_view(scratch);
+        std::sort(view.begin(), view.end());
+        clobber_memory();
+    });
+}
+
+template<typename T>
+void bench_bulk_stores(std::vector<T> & data, const std::size_t bytes)
+{
+    const std::size_t count = data.size();
+    const char * tname      = type_name<T>();
+
+    std::vector<T> dest(count);
+    run_bench("fill/std_fill", tname, bytes, count, [&] {
+        std::fill(dest.begin(), dest.end(), T{ 1 });
+        clobber_memory();
+    });
+    run_bench("fill/array_view", tname, bytes, count, [&] {
+        make_array_view(dest).fill(T{ 1 });
+        clobber_memory();
+    });
+    run_bench("fill/array_view_non_temporal", tname, bytes, count, [&] {
+        make_array_view(dest).fill(T{ 1 }, array_view_store_hint::non_temporal);
+        clobber_memory();
+    });
+    run_bench("copy/memcpy", tname, bytes, count, [&] {
+        std::memcpy(dest.data(), data.data(), count * sizeof(T));
+        clobber_memory();
+    });
+    run_bench("copy/array_view", tname, bytes, count, [&] {
+        make_array_view(dest).copy_from(make_array_view(data));
+        clobber_memory();
+    });
+    run_bench("copy/array_view_non_temporal", tname, bytes, count, [&] {
+        make_array_view(dest).copy_from(make_array_view(data), array_view_store_hint::non_temporal);
+        clobber_memory();
+    });
+}
+
+template<typename T>
+void bench_contiguous()
+{
+    for (const std::size_t bytes : working_set_bytes())
+    {
+        std::vector<T> data = make_data<T>(bytes / sizeof(T));
+        bench_iteration(data, bytes);
+        bench_random_access(data, bytes);
+        bench_slice(data, bytes);
+        bench_equality(data, bytes);
+        bench_algorithms(data, bytes);
+        bench_bulk_stores(data, bytes);
+    }
+}
+
+// Text-like bytes, lines of random letters: the log/protocol parsing case.
+void bench_byte_search()
+{
+    for (const std::size_t bytes : working_set_bytes())
+    {
+        std::vector<std::uint8_t> text(bytes);
+        std::mt19937 rng{ 1234 };
+        for (auto & byte : text)
+        {
+            byte = static_cast<std::uint8_t>('a' + rng() % 26);
+        }
+        for (std::size_t i = 79; i < bytes; i += 80)
+        {
+            text[i] = '\n';
+        }
+        const array_view<const std::uint8_t> view = make_array_view(text);
+        const std::uint8_t delimiters[] = { ' ', '\t', '\r', '\0' };
+
+        run_bench("find/std_find", "uint8", bytes, bytes, [&] {
+            do_not_optimize(std::find(view.begin(), view.end(), std::uint8_t{ '#' }));
+        });
+        run_bench("find/array_view", "uint8", bytes, bytes, [&] {
+            do_not_optimize(view.find('#'));
+        });
+        run_bench("find_first_of/std_find_first_of", "uint8", bytes, bytes, [&] {
+            do_not_optimize(std::find_first_of(view.begin(), view.end(), std::begin(delimiters), std::end(delimiters)));
+        });
+        run_bench("find_first_of/array_view", "uint8", bytes, bytes, [&] {
+            do_not_optimize(view.find_first_of(make_array_view(delimiters)));
+        });
+        run_bench("count/std_count", "uint8", bytes, bytes, [&] {
+            do_not_optimize(std::count(view.begin(), view.end(), std::uint8_t{ '\n' }));
+        });
+        run_bench("count/array_view", "uint8", bytes, bytes, [&] {
+            do_not_optimize(view.count('\n'));
+        });
+        run_bench("split/array_view", "uint8", bytes, bytes, [&] {
+            std::size_t lines = 0;
+            for (const auto line : view.split('\n'))
+            {
+                lines += line.size();
+            }
+            do_not_optimize(lines);
+        });
+    }
+}
+
+// ========================================================
+// Strided benchmarks:
+// ========================================================
+
+// A float member followed by padding, so sizeof == StrideBytes.
+template<std::size_t StrideBytes>
+struct record
+{
+    float value;
+    std::uint8_t padding[StrideBytes - sizeof(float)];
+};
+
+template<std::size_t StrideBytes>
+void bench_strided_stride()
+{
+    using record_type = record<StrideBytes>;
+    static_assert(sizeof(record_type) == StrideBytes, "unexpected record padding");
+
+    char name_suffix[32];
+    std::snprintf(name_suffix, sizeof(name_suffix), "stride%zu", StrideBytes);
+
+    for (const std::size_t bytes : working_set_bytes())
+    {
+        const std::size_t count = bytes / sizeof(record_type);
+        std::vector<record_type> records(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            records[i].value = static_cast<float>(i % 1000);
+        }
+
+        const record_type * const ptr = records.data();
+
+        run_bench("strided/raw_ptr", name_suffix, bytes, count, [&] {
+            float sum = 0.0f;
+            for (std::size_t i = 0; i < count; ++i) { sum += ptr[i].value; }
+            do_not_optimize(sum);
+        });
+        run_bench("strided/static_iter", name_suffix, bytes, count, [&] {
+            const strided_array_view<const float, 0, StrideBytes> view{ ptr, count };
+            float sum = 0.0f;
+            for (const float value : view) { sum += value; }
+            do_not_optimize(sum);
+        });
+        run_bench("strided/static_index", name_suffix, bytes, count, [&] {
+            const strided_array_view<const float, 0, StrideBytes> view{ ptr, count };
+            float sum = 0.0f;
+            for (std::size_t i = 0; i < view.size(); ++i) { sum += view[i]; }
+            do_not_optimize(sum);
+        });
+        run_bench("strided/dynamic_index", name_suffix, bytes, count, [&] {
+            const dynamic_strided_array_view<const float> view{ ptr, count, 0, StrideBytes };
+            float sum = 0.0f;
+            for (std::size_t i = 0; i < view.size(); ++i) { sum += view[i]; }
+            do_not_optimize(sum);
+        });
+
+        run_bench("strided/for_each_prefetched", name_suffix, bytes, count, [&] {
+            const strided_array_view<const float, 0, StrideBytes> view{ ptr, count };
+            float sum = 0.0f;
+            for_each_prefetched(view, [&sum](const float value) { sum += value; });
+            do_not_optimize(sum);
+        });
+
+        std::vector<float> gathered(count);
+        run_bench("strided/gather_to", name_suffix, bytes, count, [&] {
+            const strided_array_view<const float, 0, StrideBytes> view{ ptr, count };
+            view.gather_to(make_array_view(gathered));
+            clobber_memory();
+        });
+    }
+}
+
+void bench_strided()
+{
+    bench_strided_stride<12>();
+    bench_strided_stride<16>();
+    bench_strided_stride<32>();
+    bench_strided_stride<36>();
+    bench_strided_stride<44>();
+    bench_strided_stride<64>();
+}
+
+} // namespace {}
+
+// ========================================================
+// main():
+// ========================================================
+
+int main(int argc, const char * argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--quick") == 0)
+        {
+            g_config.quick       = true;
+            g_config.min_seconds = 0.02;
+            g_config.repetitions = 3;
+        }
+        else if (std::strncmp(argv[i], "--filter=", 9) == 0)
+        {
+            g_config.filter = argv[i] + 9;
+        }
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--quick] [--filter=<substring>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::printf("name,type,bytes,ns_per_item\n");
+
+    bench_contiguous<std::int32_t>();
+    bench_contiguous<float>();
+    bench_contiguous<double>();
+    bench_byte_search();
+    bench_strided();
+
+    return 0;
+}
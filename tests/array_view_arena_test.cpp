@@ -0,0 +1,159 @@
+// ================================================================================================
+// -*- C++ -*-
+// File: array_view_arena_test.cpp
+// Author: Guilherme R. Lampert
+// Created on: 14/10/26
+//
+// About:
+//  Tests for arena: allocations that don't fit the rest of the current block,
+//  oversized allocations getting their own block, over-aligned allocations,
+//  and allocate_copy() constructing into raw storage. Self-contained, exits
+//  with a non-zero status on the first failure. Build and run with debug
+//  checks on, and ideally with -fsanitize=address too, e.g.:
+//
+//   c++ -std=c++11 -O2 -DARRAY_VIEW_DEBUG_CHECKS=1 -I.. array_view_arena_test.cpp -o arena_test
+//
+// License:
+//  This software is in the public domain. Where that dedication is not recognized,
+//  you are granted a perpetual, irrevocable license to copy, distribute, and modify
+//  this file as you see fit. Source code is provided "as is", without warranty of any
+//  kind, express or implied. No attribution is required, but a mention about the author
+//  is appreciated.
+// ================================================================================================
+
+#include "array_view_arena.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define TEST_CHECK(expr)                                                          \
+    do                                                                            \
+    {                                                                             \
+        if (!(expr))                                                              \
+        {                                                                         \
+            std::printf("%s(%d): check failed: %s\n", __FILE__, __LINE__, #expr); \
+            std::exit(EXIT_FAILURE);                                              \
+        }                                                                         \
+    } while (0)
+
+// The whole [ptr, ptr + size) range must be inside one of the arena's blocks.
+static void check_allocation(const arena & owner, const void * ptr, const std::size_t size, const std::size_t alignment)
+{
+    const auto * const bytes = static_cast<const std::uint8_t *>(ptr);
+    TEST_CHECK(ptr != nullptr);
+    TEST_CHECK(reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0);
+    TEST_CHECK(owner.owns(bytes));
+    TEST_CHECK(owner.owns(bytes + size - 1));
+}
+
+// ========================================================
+// Allocations past the end of the current block:
+// ========================================================
+
+static void test_oversized_then_small()
+{
+    arena scratch;
+
+    // Bigger than a block, so it gets a block of its own that it fills exactly.
+    array_view<char> big = scratch.allocate_view<char>(arena::default_block_size + 4465);
+    check_allocation(scratch, big.data(), big.size(), 1);
+    big[big.size() - 1] = 'x';
+
+    // Aligning the full block's cursor lands past its end.
+    array_view<double> small = scratch.allocate_view<double>(1, 1.0);
+    check_allocation(scratch, small.data(), small.size_bytes(), alignof(double));
+    TEST_CHECK(small[0] == 1.0);
+    TEST_CHECK(big[big.size() - 1] == 'x');
+}
+
+static void test_padding_past_block_end()
+{
+    arena scratch{ 100 };
+
+    void * const first = scratch.allocate_bytes(97, 1);
+    check_allocation(scratch, first, 97, 1);
+
+    // 97 wasn't a multiple of 16, so the padding alone passes the end of the block.
+    void * const second = scratch.allocate_bytes(8, 16);
+    check_allocation(scratch, second, 8, 16);
+    std::memset(second, 0xAB, 8);
+
+    // Fits the remaining space exactly.
+    void * const third = scratch.allocate_bytes(92, 1);
+    check_allocation(scratch, third, 92, 1);
+    std::memset(third, 0xCD, 92);
+    TEST_CHECK(static_cast<std::uint8_t *>(third) == static_cast<std::uint8_t *>(second) + 8);
+}
+
+static void test_over_aligned()
+{
+    arena scratch{ 256 };
+    for (std::size_t alignment = 1; alignment <= 4096; alignment *= 2)
+    {
+        for (std::size_t size = 1; size <= 300; size += 37)
+        {
+            void * const ptr = scratch.allocate_bytes(size, alignment);
+            check_allocation(scratch, ptr, size, alignment);
+            std::memset(ptr, 0x5A, size);
+        }
+    }
+
+    // Same sequence again over the blocks kept by reset().
+    scratch.reset();
+    for (std::size_t alignment = 4096; alignment >= 1; alignment /= 2)
+    {
+        for (std::size_t step = 0; step < 8; ++step)
+        {
+            const std::size_t size = 300 - step * 41;
+            void * const ptr = scratch.allocate_bytes(size, alignment);
+            check_allocation(scratch, ptr, size, alignment);
+            std::memset(ptr, 0xA5, size);
+        }
+    }
+}
+
+// ========================================================
+// allocate_copy():
+// ========================================================
+
+// Assigning to an item that was never constructed is caught by the self pointer.
+// Trivially destructible, as the arena requires.
+struct tracked_item
+{
+    const tracked_item * self;
+    int value;
+
+    explicit tracked_item(const int v = 0) : self{ this }, value{ v } { }
+    tracked_item(const tracked_item & other) : self{ this }, value{ other.value } { }
+    tracked_item & operator = (const tracked_item & other)
+    {
+        TEST_CHECK(self == this);
+        value = other.value;
+        return *this;
+    }
+};
+
+static void test_allocate_copy()
+{
+    arena scratch{ 128 };
+
+    tracked_item items[5] = { tracked_item{ 1 }, tracked_item{ 2 }, tracked_item{ 3 }, tracked_item{ 4 }, tracked_item{ 5 } };
+    array_view<tracked_item> copy = scratch.allocate_copy(make_array_view(items));
+    TEST_CHECK(copy.size() == 5);
+    for (std::size_t i = 0; i < copy.size(); ++i)
+    {
+        TEST_CHECK(copy[i].self == &copy[i]);
+        TEST_CHECK(copy[i].value == static_cast<int>(i + 1));
+    }
+}
+
+int main()
+{
+    test_oversized_then_small();
+    test_padding_past_block_end();
+    test_over_aligned();
+    test_allocate_copy();
+    std::printf("arena tests passed\n");
+    return 0;
+}
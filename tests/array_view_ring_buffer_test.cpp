@@ -0,0 +1,206 @@
+// ================================================================================================
+// -*- C++ -*-
+// File: array_view_ring_buffer_test.cpp
+// Author: Guilherme R. Lampert
+// Created on: 14/10/26
+//
+// About:
+//  Tests for ring_buffer: single and multi-producer threaded FIFO order,
+//  and committing the empty window of a failed prepare_write(). Self-contained,
+//  exits with a non-zero status on the first failure. Build and run with
+//  debug checks on, and ideally with -fsanitize=thread too, e.g.:
+//
+//   c++ -std=c++11 -O2 -DARRAY_VIEW_DEBUG_CHECKS=1 -I.. array_view_ring_buffer_test.cpp -o ring_buffer_test -pthread
+//
+// License:
+//  This software is in the public domain. Where that dedication is not recognized,
+//  you are granted a perpetual, irrevocable license to copy, distribute, and modify
+//  this file as you see fit. Source code is provided "as is", without warranty of any
+//  kind, express or implied. No attribution is required, but a mention about the author
+//  is appreciated.
+// ================================================================================================
+
+#include "array_view_ring_buffer.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#define TEST_CHECK(expr)                                                          \
+    do                                                                            \
+    {                                                                             \
+        if (!(expr))                                                              \
+        {                                                                         \
+            std::printf("%s(%d): check failed: %s\n", __FILE__, __LINE__, #expr); \
+            std::exit(EXIT_FAILURE);                                              \
+        }                                                                         \
+    } while (0)
+
+// ========================================================
+// Failed reservations:
+// ========================================================
+
+template<typename ProducerMode>
+static void test_failed_prepare_write()
+{
+    ring_buffer<int, ProducerMode> queue{ 4, /* allow_double_mapping = */ false };
+    const std::size_t capacity = queue.capacity();
+
+    auto window = queue.prepare_write(2);
+    TEST_CHECK(window.size() == 2);
+    window[0] = 10;
+    window[1] = 11;
+    queue.commit_write(window);
+    TEST_CHECK(queue.size() == 2);
+
+    // No room: the window is empty and committing it must change nothing.
+    auto failed = queue.prepare_write(capacity);
+    TEST_CHECK(failed.empty());
+    queue.commit_write(failed);
+    TEST_CHECK(queue.size() == 2);
+
+    auto readable = queue.prepare_read();
+    TEST_CHECK(readable.size() == 2);
+    TEST_CHECK(readable[0] == 10 && readable[1] == 11);
+    queue.commit_read(readable.size());
+    TEST_CHECK(queue.empty());
+
+    // The queue still works after the failed commit.
+    auto next = queue.prepare_write(capacity);
+    TEST_CHECK(next.size() == capacity);
+    for (std::size_t i = 0; i < capacity; ++i)
+    {
+        next[i] = static_cast<int>(100 + i);
+    }
+    queue.commit_write(next);
+    TEST_CHECK(queue.size() == capacity);
+    readable = queue.prepare_read();
+    TEST_CHECK(readable.size() == capacity);
+    TEST_CHECK(readable[capacity - 1] == static_cast<int>(100 + capacity - 1));
+    queue.commit_read(readable.size());
+    TEST_CHECK(queue.empty());
+}
+
+// ========================================================
+// Threaded FIFO order:
+// ========================================================
+
+static void test_spsc(const bool allow_double_mapping)
+{
+    const std::uint64_t total = 200000;
+    ring_buffer<std::uint64_t> queue{ 256, allow_double_mapping };
+
+    std::thread producer([&] {
+        std::uint64_t next = 0;
+        while (next < total)
+        {
+            // Alternate exact-size requests, which fail when the queue is
+            // full, with partial ones.
+            const std::size_t wanted = static_cast<std::size_t>(std::min<std::uint64_t>(1 + next % 61, total - next));
+            auto window = (next % 2 == 0) ? queue.prepare_write(wanted) : queue.prepare_write_up_to(wanted);
+            for (std::size_t i = 0; i < window.size(); ++i)
+            {
+                window[i] = next + i;
+            }
+            next += window.size();
+            queue.commit_write(window);
+            if (window.empty())
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::uint64_t expected = 0;
+    while (expected < total)
+    {
+        auto window = queue.prepare_read(97);
+        TEST_CHECK(window.size() <= queue.capacity());
+        for (std::size_t i = 0; i < window.size(); ++i)
+        {
+            TEST_CHECK(window[i] == expected + i);
+        }
+        expected += window.size();
+        queue.commit_read(window.size());
+        if (window.empty())
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    TEST_CHECK(queue.empty());
+}
+
+static void test_mpsc(const bool allow_double_mapping)
+{
+    const unsigned producer_count = 4;
+    const std::uint64_t per_producer = 50000;
+    ring_buffer<std::uint64_t, ring_buffer_multi_producer> queue{ 128, allow_double_mapping };
+
+    // Items are (producer << 32) | index; each producer's items must arrive in order.
+    std::vector<std::thread> producers;
+    for (unsigned p = 0; p < producer_count; ++p)
+    {
+        producers.emplace_back([&queue, p, per_producer] {
+            std::uint64_t next = 0;
+            while (next < per_producer)
+            {
+                const std::size_t wanted = static_cast<std::size_t>(std::min<std::uint64_t>(1 + (next + p) % 13, per_producer - next));
+                auto window = queue.prepare_write(wanted);
+                for (std::size_t i = 0; i < window.size(); ++i)
+                {
+                    window[i] = (static_cast<std::uint64_t>(p) << 32) | (next + i);
+                }
+                next += window.size();
+                queue.commit_write(window); // Also for failed reservations.
+                if (window.empty())
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<std::uint64_t> next_expected(producer_count, 0);
+    std::uint64_t received = 0;
+    while (received < producer_count * per_producer)
+    {
+        auto window = queue.prepare_read();
+        for (std::size_t i = 0; i < window.size(); ++i)
+        {
+            const unsigned p = static_cast<unsigned>(window[i] >> 32);
+            TEST_CHECK(p < producer_count);
+            TEST_CHECK((window[i] & 0xFFFFFFFFu) == next_expected[p]);
+            ++next_expected[p];
+        }
+        received += window.size();
+        queue.commit_read(window.size());
+        if (window.empty())
+        {
+            std::this_thread::yield();
+        }
+    }
+    for (auto & producer : producers)
+    {
+        producer.join();
+    }
+    for (unsigned p = 0; p < producer_count; ++p)
+    {
+        TEST_CHECK(next_expected[p] == per_producer);
+    }
+    TEST_CHECK(queue.empty());
+}
+
+int main()
+{
+    test_failed_prepare_write<ring_buffer_single_producer>();
+    test_failed_prepare_write<ring_buffer_multi_producer>();
+    for (const bool allow_double_mapping : { false, true })
+    {
+        test_spsc(allow_double_mapping);
+        test_mpsc(allow_double_mapping);
+    }
+    std::printf("ring_buffer tests passed\n");
+    return 0;
+}